@@ -0,0 +1,179 @@
+// Copyright (c) 2025-2026 Kaius Ruokonen. All rights reserved.
+// SPDX-License-Identifier: MIT
+// See the LICENSE file in the project root for full license text.
+
+module net;
+import tester;
+import std;
+
+using namespace std::string_literals;
+using namespace std::string_view_literals;
+
+namespace {
+using tester::assertions::check_eq;
+using tester::assertions::check_true;
+using tester::assertions::check_false;
+
+using range_status = http::byte_range::status;
+
+// A scratch file under the temp directory, removed again on scope exit.
+struct scratch_file
+{
+    explicit scratch_file(std::string_view contents)
+        : path{(std::filesystem::temp_directory_path()
+                / std::format("net_http_file_{}_{}", std::chrono::steady_clock::now().time_since_epoch().count(), counter()++)).string()}
+    {
+        auto out = std::ofstream{path, std::ios::binary};
+        out.write(contents.data(), static_cast<std::streamsize>(contents.size()));
+    }
+
+    ~scratch_file()
+    {
+        auto ec = std::error_code{};
+        std::filesystem::remove(path, ec);
+    }
+
+    static std::atomic<int>& counter()
+    {
+        static auto n = std::atomic<int>{0};
+        return n;
+    }
+
+    std::string path;
+};
+}
+
+auto register_http_file_tests()
+{
+    tester::bdd::scenario("Byte ranges resolve against the file size, [net]") = [] {
+        const auto r = http::parse_range("bytes=0-9", 100);
+        check_true(r.state == range_status::partial);
+        check_eq(r.first, std::size_t{0});
+        check_eq(r.length, std::size_t{10});
+
+        check_eq(http::parse_range("bytes=90-", 100).length, std::size_t{10});
+        check_eq(http::parse_range("bytes=-5", 100).first, std::size_t{95});
+        check_eq(http::parse_range("bytes=-500", 100).length, std::size_t{100});
+        check_eq(http::parse_range("bytes=50-1000", 100).length, std::size_t{50});
+
+        tester::bdd::then("Ranges past the end are unsatisfiable") = [] {
+            check_true(http::parse_range("bytes=100-", 100).state == range_status::unsatisfiable);
+            check_true(http::parse_range("bytes=-0", 100).state == range_status::unsatisfiable);
+            check_true(http::parse_range("bytes=0-0", 0).state == range_status::unsatisfiable);
+        };
+
+        tester::bdd::then("Other units, lists and bad syntax serve the whole file") = [] {
+            check_true(http::parse_range("items=0-1", 100).state == range_status::whole);
+            check_true(http::parse_range("bytes=0-1,5-6", 100).state == range_status::whole);
+            check_true(http::parse_range("bytes=5-1", 100).state == range_status::whole);
+            check_true(http::parse_range("bytes=a-", 100).state == range_status::whole);
+        };
+    };
+
+    tester::bdd::scenario("If-None-Match compares entity tags weakly, [net]") = [] {
+        check_true(http::etag_matches(R"("a", W/"b")", R"("b")"));
+        check_true(http::etag_matches("*", R"("b")"));
+        check_false(http::etag_matches(R"("c")", R"("b")"));
+    };
+
+    tester::bdd::scenario("Content types follow the file extension, [net]") = [] {
+        check_eq(http::mime_type("assets/Site.CSS"), "text/css; charset=utf-8"sv);
+        check_eq(http::mime_type("logo.png"), "image/png"sv);
+        check_eq(http::mime_type("archive.d/README"), "application/octet-stream"sv);
+    };
+
+    tester::bdd::scenario("Directory targets resolve below the root only, [net]") = [] {
+        check_eq(http::resolve_file("/www", "/static", "/static/a/b.css?v=1").value_or(""), "/www/a/b.css"s);
+        check_eq(http::resolve_file("/www", "/static", "/static/").value_or(""), "/www/index.html"s);
+        check_eq(http::resolve_file("/www", "/static", "/static/sp%20ace").value_or(""), "/www/sp ace"s);
+        check_false(http::resolve_file("/www", "/static", "/static/../etc/passwd").has_value());
+        check_false(http::resolve_file("/www", "/static", "/static/%2e%2e/etc/passwd").has_value());
+        check_false(http::resolve_file("/www", "/static", "/static/a%00b").has_value());
+        check_false(http::resolve_file("/www", "/static", "/staticx/a").has_value());
+
+        // Only two hex digits make an escape; a sign is not one.
+        check_eq(http::resolve_file("/www", "/static", "/static/a%-1b").value_or(""), "/www/a%-1b"s);
+        check_eq(http::resolve_file("/www", "/static", "/static/a%+fb").value_or(""), "/www/a%+fb"s);
+        check_eq(http::resolve_file("/www", "/static", "/static/a%4Gb").value_or(""), "/www/a%4Gb"s);
+    };
+
+    tester::bdd::scenario("File cache keeps rooted paths below the root, [net]") = [] {
+        const auto base = std::filesystem::temp_directory_path()
+            / std::format("net_http_root_{}", std::chrono::steady_clock::now().time_since_epoch().count());
+        const auto root = base / "www";
+        std::filesystem::create_directories(root);
+        auto outside = scratch_file{"secret"};
+        {
+            auto out = std::ofstream{root / "inside.txt", std::ios::binary};
+            out << "public";
+        }
+        auto ec = std::error_code{};
+        std::filesystem::create_symlink(outside.path, root / "escape.txt", ec);
+        std::filesystem::create_symlink(root / "inside.txt", root / "alias.txt", ec);
+
+        auto cache = http::file_cache{8, std::chrono::milliseconds{0}};
+        const auto inside = cache.open((root / "inside.txt").string(), root.string());
+        check_eq(inside ? inside->contents().value_or("") : ""sv, "public"sv);
+        check_true(cache.open((root / "alias.txt").string(), root.string()) != nullptr);
+        check_true(cache.open((root / "escape.txt").string(), root.string()) == nullptr);
+
+        // Without a root the same link is followed, as file routes do.
+        check_true(cache.open((root / "escape.txt").string()) != nullptr);
+        check_true(cache.open((root / "escape.txt").string(), root.string()) == nullptr);
+
+        std::filesystem::remove_all(base, ec);
+    };
+
+    tester::bdd::scenario("File cache reuses open files until they change, [net]") = [] {
+        auto small = scratch_file{"hello world"};
+        auto large = scratch_file{std::string(http::file_entry::inline_limit + 1, 'x')};
+        auto cache = http::file_cache{8, std::chrono::milliseconds{0}};
+
+        const auto entry = cache.open(small.path);
+        check_true(entry != nullptr);
+        if(not entry)
+            return;
+        check_eq(entry->size(), std::size_t{11});
+        check_eq(entry->contents().value_or(""), "hello world"sv);
+        check_true(entry->etag().starts_with('"'));
+
+        // Revalidated by stat on every call here, and still the same entry.
+        check_true(cache.open(small.path) == entry);
+        check_eq(cache.size(), std::size_t{1});
+
+        // Large files are streamed from the fd, not held in memory.
+        const auto big = cache.open(large.path);
+        check_true(big != nullptr and not big->contents().has_value());
+
+        {
+            auto out = std::ofstream{small.path, std::ios::binary | std::ios::app};
+            out << '!';
+        }
+        const auto changed = cache.open(small.path);
+        check_true(changed != nullptr and changed != entry);
+        check_eq(changed ? changed->size() : 0, std::size_t{12});
+
+        check_true(cache.open(small.path + ".missing") == nullptr);
+        check_true(cache.open(std::filesystem::temp_directory_path().string()) == nullptr);
+    };
+
+    tester::bdd::scenario("Cached small files survive truncation underneath them, [net]") = [] {
+        auto small = scratch_file{"hello world"};
+        auto cache = http::file_cache{8, std::chrono::seconds{60}};
+
+        const auto entry = cache.open(small.path);
+        check_true(entry != nullptr and entry->contents().has_value());
+        if(not entry)
+            return;
+
+        // The entry holds its own copy: reading it after the file is cut to
+        // nothing returns the old bytes instead of faulting.
+        std::filesystem::resize_file(small.path, 0);
+        check_eq(entry->contents().value_or(""), "hello world"sv);
+        check_true(cache.open(small.path) == entry);
+    };
+
+    return true;
+}
+
+const auto _ = register_http_file_tests();
@@ -0,0 +1,311 @@
+// Copyright (c) 2025-2026 Kaius Ruokonen. All rights reserved.
+// SPDX-License-Identifier: MIT
+// See the LICENSE file in the project root for full license text.
+
+module net;
+import tester;
+import std;
+
+using namespace std::string_literals;
+using namespace std::string_view_literals;
+
+namespace {
+using tester::assertions::check_eq;
+using tester::assertions::check_true;
+using tester::assertions::check_false;
+
+using status = http::request_parser::status;
+
+// Feed `input` in chunks of `chunk` bytes, as successive recv()s would.
+inline std::size_t feed_in_chunks(http::request_parser& parser, std::string_view input, std::size_t chunk)
+{
+    auto consumed = std::size_t{0};
+    while(consumed < input.size() and parser.state() == status::incomplete)
+        consumed += parser.feed(input.substr(consumed, chunk));
+    return consumed;
+}
+
+// Memory resource that counts the allocations made through it, so only the
+// parse path under measurement is counted.
+class counting_resource : public std::pmr::memory_resource
+{
+public:
+    [[nodiscard]] std::size_t allocations() const noexcept { return m_allocations; }
+
+private:
+    void* do_allocate(std::size_t bytes, std::size_t alignment) override
+    {
+        ++m_allocations;
+        return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+    }
+
+    void do_deallocate(void* p, std::size_t bytes, std::size_t alignment) override
+    {
+        std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override
+    {
+        return this == &other;
+    }
+
+    std::size_t m_allocations = 0;
+};
+
+using counted_istringstream = std::basic_istringstream<char, std::char_traits<char>, std::pmr::polymorphic_allocator<char>>;
+
+// http::headers on counted storage: its flat_map is a pair of sorted vectors,
+// one string per name and per value.
+class counted_headers
+{
+public:
+    explicit counted_headers(std::pmr::memory_resource* resource) : m_names{resource}, m_values{resource} {}
+
+    void set(std::string_view name, std::string_view value)
+    {
+        auto key = std::pmr::string{name, m_names.get_allocator()};
+        for(auto& ch : key)
+            if(ch >= 'A' and ch <= 'Z')
+                ch = static_cast<char>(ch + ('a' - 'A'));
+        const auto at = std::ranges::lower_bound(m_names, key);
+        const auto i = at - m_names.begin();
+        if(at != m_names.end() and *at == key)
+            m_values[i].assign(value);
+        else
+        {
+            m_names.insert(at, std::move(key));
+            m_values.emplace(m_values.begin() + i, value);
+        }
+    }
+
+    [[nodiscard]] bool contains(std::string_view name) const
+    {
+        return std::ranges::binary_search(m_names, name, std::less<>{});
+    }
+
+private:
+    std::pmr::vector<std::pmr::string> m_names;
+    std::pmr::vector<std::pmr::string> m_values;
+};
+
+// The request-head path before http::request_parser: byte-wise get() into a
+// string, then istringstream and operator>> for the request line and headers,
+// all on `resource`.
+inline bool parse_with_streams(std::istream& in, std::pmr::memory_resource* resource)
+{
+    auto head = std::pmr::string{resource};
+    head.reserve(256);
+    while(not ((head.size() >= 4 and head.ends_with("\r\n\r\n")) or (head.size() >= 2 and head.ends_with("\n\n"))))
+    {
+        const auto ch = in.get();
+        if(not in.good())
+            return false;
+        head.push_back(static_cast<char>(ch));
+    }
+    auto parse = counted_istringstream{std::pmr::string{head, resource}};
+    auto method = std::pmr::string{resource}, uri = std::pmr::string{resource}, version = std::pmr::string{resource};
+    parse >> method >> uri >> version >> net::crlf;
+    auto hs = counted_headers{resource};
+    for(auto line = std::pmr::string{resource}; parse.peek() != '\r' and parse.peek() != '\n' and std::getline(parse, line);)
+        if(const auto colon = line.find(':'); colon != line.npos)
+            hs.set(utils::trim(std::string_view{line}.substr(0, colon)), utils::trim(std::string_view{line}.substr(colon + 1)));
+    return not method.empty() and hs.contains("host");
+}
+
+// Feed one head in input-area sized slices, as serve_request does.
+inline bool parse_in_place(http::request_parser& parser, std::string_view& in)
+{
+    parser.reset();
+    while(parser.state() == http::request_parser::status::incomplete and not in.empty())
+        in.remove_prefix(parser.feed(in.substr(0, net::tcp_buffer_size)));
+    return parser.state() == http::request_parser::status::complete;
+}
+
+struct parse_figures
+{
+    double bytes_per_second;
+    double allocations_per_request;
+};
+
+// Run parse_all(input) -> requests parsed, `rounds` times; allocations are
+// those made through `counted`.
+inline parse_figures measure_parse(std::string_view input, int rounds, const counting_resource& counted, auto parse_all)
+{
+    auto requests = std::size_t{0};
+    const auto allocations_before = counted.allocations();
+    const auto start = std::chrono::steady_clock::now();
+    for(auto i = 0; i < rounds; ++i)
+        requests += parse_all(input);
+    const auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return {
+        static_cast<double>(input.size()) * rounds / elapsed,
+        static_cast<double>(counted.allocations() - allocations_before) / static_cast<double>(std::max<std::size_t>(requests, 1))};
+}
+}
+
+auto register_http_parser_tests()
+{
+    tester::bdd::scenario("Request parser exposes the head as views, [net]") = [] {
+        const auto raw = "GET /items?id=7 HTTP/1.1\r\n"
+                         "Host: example.com\r\n"
+                         "X-Custom-Header:   padded value  \r\n"
+                         "No-Colon-Line\r\n"
+                         ":Value-Only\r\n"
+                         "\r\n"sv;
+        auto parser = http::request_parser{1024};
+        check_eq(parser.feed(raw), raw.size());
+        check_true(parser.state() == status::complete);
+        check_eq(parser.size(), raw.size());
+        check_eq(parser.method(), "GET"sv);
+        check_eq(parser.uri(), "/items?id=7"sv);
+        check_eq(parser.version(), "HTTP/1.1"sv);
+        check_eq(parser.fields().size(), std::size_t{3});
+        check_eq(parser.field_value("host").value_or(""), "example.com"sv);
+        check_eq(parser.field_value("x-custom-header").value_or(""), "padded value"sv);
+        check_eq(parser.field_value("").value_or("missing"), "Value-Only"sv);
+        check_false(parser.field_value("no-colon-line").has_value());
+    };
+
+    tester::bdd::scenario("Request parser resumes across partial input, [net]") = [] {
+        const auto raw = "POST /upload HTTP/1.1\r\nHost: h\r\nContent-Length: 4\r\n\r\n"sv;
+        for(const auto chunk : {std::size_t{1}, std::size_t{2}, std::size_t{7}, raw.size()})
+        {
+            auto parser = http::request_parser{1024};
+            check_eq(feed_in_chunks(parser, raw, chunk), raw.size());
+            check_true(parser.state() == status::complete);
+            check_eq(parser.method(), "POST"sv);
+            check_eq(parser.field_value("content-length").value_or(""), "4"sv);
+        }
+    };
+
+    tester::bdd::scenario("Request parser stops at the head terminator, [net]") = [] {
+        const auto first = "GET /a HTTP/1.1\r\nHost: h\r\n\r\n"sv;
+        const auto second = "GET /b HTTP/1.1\nHost: h\n\n"sv;
+        const auto pipelined = std::string{first} + "body" + std::string{second};
+        auto parser = http::request_parser{1024};
+
+        // Body and the pipelined request stay with the caller.
+        check_eq(parser.feed(pipelined), first.size());
+        check_eq(parser.uri(), "/a"sv);
+        check_eq(parser.feed(pipelined), std::size_t{0});
+
+        // reset() readies the parser for the next head, LF-only included.
+        parser.reset();
+        check_eq(parser.feed(std::string_view{pipelined}.substr(first.size() + 4)), second.size());
+        check_true(parser.state() == status::complete);
+        check_eq(parser.uri(), "/b"sv);
+    };
+
+    tester::bdd::scenario("Request parser skips empty lines before the request line, [net]") = [] {
+        auto parser = http::request_parser{1024};
+        parser.feed("\r\n\nGET / HTTP/1.1\r\nHost: h\r\n\r\n"sv);
+        check_true(parser.state() == status::complete);
+        check_eq(parser.method(), "GET"sv);
+    };
+
+    tester::bdd::scenario("Request parser enforces the head size cap, [net]") = [] {
+        const auto raw = "GET / HTTP/1.1\r\nHost: h\r\n\r\n"sv;
+
+        tester::bdd::then("A head of exactly the cap is accepted") = [raw] {
+            auto parser = http::request_parser{raw.size()};
+            check_eq(parser.feed(raw), raw.size());
+            check_true(parser.state() == status::complete);
+        };
+
+        tester::bdd::then("One byte less is too large") = [raw] {
+            auto parser = http::request_parser{raw.size() - 1};
+            check_eq(feed_in_chunks(parser, raw, 5), raw.size() - 1);
+            check_true(parser.state() == status::too_large);
+        };
+    };
+
+    tester::bdd::scenario("Request parser rejects malformed heads, [net]") = [] {
+        tester::bdd::then("A request line with missing parts") = [] {
+            auto parser = http::request_parser{1024};
+            parser.feed("GET /\r\nHost: h\r\n\r\n"sv);
+            check_true(parser.state() == status::bad_request);
+            check_true(parser.uri().empty());
+        };
+
+        tester::bdd::then("Duplicate Content-Length, case-insensitively") = [] {
+            auto parser = http::request_parser{1024};
+            parser.feed("POST / HTTP/1.1\r\nHost: h\r\nContent-Length: 1\r\ncontent-LENGTH: 2\r\n\r\n"sv);
+            check_true(parser.state() == status::bad_request);
+            check_eq(parser.error(), "duplicate Content-Length header"sv);
+        };
+
+        tester::bdd::then("Duplicate Host") = [] {
+            auto parser = http::request_parser{1024};
+            parser.feed("GET / HTTP/1.1\r\nHost: a\r\nHost: b\r\n\r\n"sv);
+            check_true(parser.state() == status::bad_request);
+            check_eq(parser.error(), "duplicate Host header"sv);
+        };
+    };
+
+    // Hidden behind [.benchmark]; select with --tags='\[\.benchmark\]'.
+    tester::bdd::scenario("Request head parsing, streams vs in-place parser, [.benchmark]") = [] {
+        const auto small = "GET /ping HTTP/1.1\r\nHost: 127.0.0.1\r\n\r\n"s;
+
+        auto large = "GET /api/v1/orders?page=2 HTTP/1.1\r\nHost: shop.example.com\r\n"s;
+        for(auto i = 0; i < 24; ++i)
+            large += std::format("X-Header-{}: value-{}-{}\r\n", i, i, std::string(40, 'v'));
+        large += "Cookie: " + std::string(2048, 'c') + "\r\n\r\n";
+
+        auto pipelined = ""s;
+        for(auto i = 0; i < 32; ++i)
+            pipelined += small;
+
+        struct workload { std::string_view name; const std::string& input; int rounds; };
+        for(const auto& [name, input, rounds] : {workload{"small", small, 200'000},
+                                                  workload{"large_headers", large, 10'000},
+                                                  workload{"pipelined_x32", pipelined, 10'000}})
+        {
+            auto counted = counting_resource{};
+            const auto streams = measure_parse(input, rounds, counted, [&counted](std::string_view in)
+            {
+                auto is = counted_istringstream{std::pmr::string{in, &counted}};
+                auto n = std::size_t{0};
+                while(parse_with_streams(is, &counted))
+                    ++n;
+                return n;
+            });
+
+            // One parser per connection, reused across its requests.
+            auto parser = http::request_parser{http::default_max_request_head_size, &counted};
+            const auto in_place = measure_parse(input, rounds, counted, [&parser](std::string_view in)
+            {
+                auto n = std::size_t{0};
+                while(parse_in_place(parser, in))
+                    ++n;
+                return n;
+            });
+
+            // What serve_request does today: parse, then build http::headers
+            // for the handlers.
+            const auto with_headers = measure_parse(input, rounds, counted, [&parser, &counted](std::string_view in)
+            {
+                auto n = std::size_t{0};
+                while(parse_in_place(parser, in))
+                {
+                    auto hs = counted_headers{&counted};
+                    for(const auto& [name, value] : parser.fields())
+                        hs.set(name, value);
+                    n += hs.contains("host");
+                }
+                return n;
+            });
+
+            // The stream path's istringstream copy of the input is counted
+            // against it, one allocation per round.
+            for(const auto& [path, figures] : {std::pair{"streams"sv, streams},
+                                               std::pair{"parser"sv, in_place},
+                                               std::pair{"parser_and_headers"sv, with_headers}})
+                std::clog << std::format("workload={} path={} mib_per_second={:.1f} allocations_per_request={:.2f}\n",
+                                         name, path, figures.bytes_per_second / (1024.0 * 1024.0), figures.allocations_per_request);
+        }
+    };
+
+    return true;
+}
+
+const auto _ = register_http_parser_tests();
@@ -0,0 +1,206 @@
+// Copyright (c) 2025-2026 Kaius Ruokonen. All rights reserved.
+// SPDX-License-Identifier: MIT
+// See the LICENSE file in the project root for full license text.
+
+module net;
+import tester;
+import std;
+
+using namespace std::string_literals;
+using namespace std::string_view_literals;
+
+namespace {
+using tester::assertions::check_eq;
+using tester::assertions::check_true;
+using tester::assertions::check_false;
+using tester::assertions::check_throws_as;
+
+inline std::vector<std::string> patterns(const http::route_matches& found)
+{
+    auto out = std::vector<std::string>{};
+    for(const auto& m : found)
+        out.push_back(*m.pattern);
+    return out;
+}
+
+// Mostly literal routes with a few regexes. No `{name}` templates: the old
+// regex-per-request dispatch cannot compile them.
+inline std::vector<std::string> route_patterns(std::size_t count)
+{
+    auto out = std::vector<std::string>{};
+    out.reserve(count);
+    for(auto i = std::size_t{0}; i < count; ++i)
+        out.push_back(i % 10 == 1 ? std::format("/api/v1/files{}/[a-z]+", i) : std::format("/api/v1/resource{}", i));
+    return out;
+}
+}
+
+auto register_http_router_tests()
+{
+    tester::bdd::scenario("Literal routes match the whole path, [net]") = [] {
+        auto table = http::route_table{};
+        table.add("/health");
+        table.add("/api/v1/status");
+        table.add("/health");
+        check_eq(table.size(), std::size_t{2});
+
+        tester::bdd::then("Exact targets match, others do not") = [table] {
+            check_eq(table.match("/health").size(), std::size_t{1});
+            check_eq(table.match("/api/v1/status").size(), std::size_t{1});
+            check_true(table.match("/health/").empty());
+            check_eq(table.match("/health?verbose=1").size(), std::size_t{1});
+            check_true(table.match("/").empty());
+        };
+    };
+
+    tester::bdd::scenario("Template routes capture {name} segments, [net]") = [] {
+        auto table = http::route_table{};
+        table.add("/users/{id}");
+        table.add("/users/{id}/orders/{order_id}");
+        table.add("/users/me");
+
+        tester::bdd::when("A single parameter is matched") = [table] {
+            const auto found = table.match("/users/42?fields=name");
+            check_eq(found.size(), std::size_t{1});
+            check_eq(*found.front().pattern, "/users/{id}"s);
+            check_eq(found.front().params["id"], "42"sv);
+            check_true(found.front().params.contains("id"));
+            check_false(found.front().params.contains("order_id"));
+        };
+
+        tester::bdd::when("Several parameters are matched") = [table] {
+            const auto found = table.match("/users/7/orders/a-1");
+            check_eq(found.size(), std::size_t{1});
+            check_eq(found.front().params.size(), std::size_t{2});
+            check_eq(found.front().params["id"], "7"sv);
+            check_eq(found.front().params["order_id"], "a-1"sv);
+        };
+
+        tester::bdd::when("A literal segment overlaps a parameter") = [table] {
+            const auto found = table.match("/users/me");
+            check_eq(patterns(found), std::vector{"/users/me"s, "/users/{id}"s});
+        };
+
+        tester::bdd::then("Empty segments and extra depth do not match") = [table] {
+            check_true(table.match("/users/").empty());
+            check_true(table.match("/users/7/orders").empty());
+            check_true(table.match("/users/7/extra").empty());
+        };
+    };
+
+    tester::bdd::scenario("Regex routes keep std::regex_match semantics, [net]") = [] {
+        auto table = http::route_table{};
+        table.add("/[a-z]*");
+        table.add("/[a-z]+/[0-9]+");
+        table.add("/foo/123");
+
+        tester::bdd::then("Every matching route is reported in pattern order") = [table] {
+            check_eq(patterns(table.match("/foo/123")), std::vector{"/[a-z]+/[0-9]+"s, "/foo/123"s});
+            check_eq(patterns(table.match("/abc")), std::vector{"/[a-z]*"s});
+            check_true(table.match("/ABC").empty());
+        };
+
+        tester::bdd::then("The query is not part of the match") = [table] {
+            check_eq(patterns(table.match("/abc?x=1")), std::vector{"/[a-z]*"s});
+            check_eq(patterns(table.match("/foo/123?page=2")), std::vector{"/[a-z]+/[0-9]+"s, "/foo/123"s});
+        };
+
+        tester::bdd::then("Invalid patterns throw at registration") = [] {
+            auto bad = http::route_table{};
+            check_throws_as<std::regex_error>([&bad]{ bad.add("/(unclosed"); });
+        };
+    };
+
+    tester::bdd::scenario("One target matches every kind of route alike, [net]") = [] {
+        auto table = http::route_table{};
+        table.add("/b/{id}");
+        table.add("/b/1");
+        table.add("/[ab]/[0-9]");
+        table.add("/a/{id}");
+
+        tester::bdd::then("Matches come in pattern order, with or without a query") = [table] {
+            const auto expected = std::vector{"/[ab]/[0-9]"s, "/b/1"s, "/b/{id}"s};
+            check_eq(patterns(table.match("/b/1")), expected);
+            check_eq(patterns(table.match("/b/1?x=/a/2")), expected);
+        };
+
+        tester::bdd::then("A reused result set is refilled, not appended to") = [table] {
+            auto found = http::route_matches{};
+            table.match("/b/1", found);
+            check_eq(found.size(), std::size_t{3});
+            table.match("/a/7?q", found);
+            check_eq(patterns(found), std::vector{"/[ab]/[0-9]"s, "/a/{id}"s});
+            check_eq(found[1].params["id"], "7"sv);
+            table.match("/nowhere", found);
+            check_true(found.empty());
+        };
+    };
+
+    tester::bdd::scenario("Routes render with path parameters, [net]") = [] {
+        auto server = http::server{};
+        server.get("/items/{id}").response_with_params("text/plain",
+            [](std::string_view, std::string_view, const http::headers&, const http::path_params& params)
+            {
+                return http::make_response("200 OK"s, "item " + std::string{params["id"]});
+            });
+
+        auto hs = http::headers{};
+        auto table = http::route_table{};
+        table.add("/items/{id}");
+        const auto matches = table.match("/items/9");
+        check_eq(matches.size(), std::size_t{1});
+        const auto [status, content, type, headers] = server.get("/items/{id}").render("/items/9", "", hs, matches.front().params);
+        check_eq(status, "200 OK"s);
+        check_eq(content, "item 9"s);
+        check_eq(type, "text/plain"s);
+    };
+
+    // Hidden behind [.benchmark]; select with --tags='\[\.benchmark\]'.
+    tester::bdd::scenario("Route matching, regex per request vs route table, [.benchmark]") = [] {
+        for(const auto count : {std::size_t{10}, std::size_t{100}, std::size_t{1000}})
+        {
+            // Keep regex constructions per run constant (~200k) across table sizes.
+            const auto lookups = static_cast<int>(200'000 / count);
+            const auto routes = route_patterns(count);
+            // Targets hit a literal route near the end, a regex route, and miss.
+            const auto targets = std::array{
+                std::format("/api/v1/resource{}", count - 2),
+                "/api/v1/files1/abc"s,
+                "/nowhere"s};
+
+            auto matched_before = std::size_t{0};
+            const auto before_start = std::chrono::steady_clock::now();
+            for(auto i = 0; i < lookups; ++i)
+                for(const auto& pattern : routes)
+                    // What dispatch did before: construct and match a regex per route per request.
+                    if(std::regex_match(targets[i % targets.size()], std::regex{pattern}))
+                        ++matched_before;
+            const auto before = std::chrono::steady_clock::now() - before_start;
+
+            auto table = http::route_table{};
+            for(const auto& pattern : routes)
+                table.add(pattern);
+            auto matched_after = std::size_t{0};
+            auto found = http::route_matches{};
+            const auto after_start = std::chrono::steady_clock::now();
+            for(auto i = 0; i < lookups; ++i)
+            {
+                table.match(targets[i % targets.size()], found);
+                matched_after += found.size();
+            }
+            const auto after = std::chrono::steady_clock::now() - after_start;
+
+            const auto per_lookup_ns = [lookups](auto elapsed)
+            {
+                return std::chrono::duration<double, std::nano>(elapsed).count() / lookups;
+            };
+            std::clog << std::format(
+                "routes={} regex_per_request_ns={:.0f} route_table_ns={:.0f} matches_before={} matches_after={}\n",
+                count, per_lookup_ns(before), per_lookup_ns(after), matched_before, matched_after);
+        }
+    };
+
+    return true;
+}
+
+const auto _ = register_http_router_tests();
@@ -4,27 +4,12 @@
 
 module net;
 import :posix;
+import :reactor;
 import tester;
 import std;
 
 using namespace net;
 
-namespace net::test {
-
-void publish_slog_capture(std::shared_ptr<std::ostream> sink)
-{
-    std::lock_guard lock{structured_log_stream::process_mutex()};
-    structured_log_stream::process_config().redirect_holder = std::move(sink);
-}
-
-void clear_slog_capture()
-{
-    std::lock_guard lock{structured_log_stream::process_mutex()};
-    structured_log_stream::process_config().redirect_holder.reset();
-}
-
-} // namespace net::test
-
 namespace {
 using namespace std::string_literals;
 using namespace std::string_view_literals;
@@ -41,13 +26,6 @@ inline bool network_tests_enabled()
     return true;
 }
 
-// recursive: slog_capture may already hold this while listen_ephemeral locks again.
-inline std::recursive_mutex& slog_capture_mutex()
-{
-    static std::recursive_mutex mutex;
-    return mutex;
-}
-
 // std::thread::~thread calls terminate if still joinable — any require_* throw
 // before an explicit join would abort the whole --jobs>1 run. Stop + join here.
 struct joining_server_thread
@@ -112,7 +90,7 @@ inline std::tuple<joining_server_thread, std::uint16_t, std::shared_ptr<std::uni
 listen_ephemeral(const std::shared_ptr<http::server>& server)
 {
     using namespace std::chrono_literals;
-    auto gate = std::make_shared<std::unique_lock<std::recursive_mutex>>(slog_capture_mutex());
+    auto gate = std::make_shared<std::unique_lock<std::recursive_mutex>>(test::slog_capture_mutex());
     auto port = std::make_shared<std::uint16_t>(0);
     auto bound = std::make_shared<std::promise<void>>();
     auto bound_future = bound->get_future();
@@ -139,7 +117,7 @@ listen_ephemeral(const std::shared_ptr<http::server>& server)
 struct slog_capture
 {
     explicit slog_capture(std::shared_ptr<std::stringstream> os)
-        : lock{slog_capture_mutex()}
+        : lock{test::slog_capture_mutex()}
         , out{std::move(os)}
     {
         slog.app_name("httptest")
@@ -1953,6 +1931,81 @@ auto register_server_tests()
         };
     };
 
+    tester::bdd::scenario("SSE hub evicts a client that never reads, [net]") = [] {
+        if(not network_tests_enabled()) return;
+
+        tester::bdd::given("A hub with a small queue behind an SSE route") = [] {
+            auto server = std::make_shared<http::server>();
+            auto events = std::make_shared<http::sse::hub>(http::sse::hub_options{.queue_capacity = 8});
+            auto served = std::make_shared<std::atomic<bool>>(false);
+
+            server->sse("/events").sse([events, served](http::sse::session& session, auto, auto&) {
+                events->serve(session);
+                served->store(true);
+            });
+
+            tester::bdd::when("The client subscribes and then stops reading") = [server, events, served] {
+                auto subscribed = false;
+                auto publish_seconds = 0.0;
+
+                auto [server_thread, port, _http_listen_gate] = listen_ephemeral(server);
+                const auto port_s = std::to_string(port);
+
+                using namespace std::chrono_literals;
+                if(port != 0)
+                {
+                    std::this_thread::sleep_for(200ms);
+                    try
+                    {
+                        // Kept open but never read: the server's writes fill both
+                        // socket buffers and then block.
+                        auto stream = connect("127.0.0.1", port_s);
+                        stream << "GET /events HTTP/1.1" << net::crlf
+                               << "Host: 127.0.0.1:" << port_s << net::crlf
+                               << net::crlf
+                               << net::flush;
+
+                        for(auto i = 0; i < 200 and events->subscribers() == 0; ++i)
+                            std::this_thread::sleep_for(10ms);
+                        subscribed = events->subscribers() == 1;
+
+                        // 64 MiB in all, far past what the kernel buffers.
+                        const auto payload = std::string(64 * 1024, 'x');
+                        const auto start = std::chrono::steady_clock::now();
+                        for(auto i = 0; i < 1024 and events->stats().evicted == 0; ++i)
+                        {
+                            events->publish(payload);
+                            std::this_thread::sleep_for(1ms);
+                        }
+                        publish_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+                        for(auto i = 0; i < 200 and not served->load(); ++i)
+                            std::this_thread::sleep_for(10ms);
+                        stream.close();
+                    }
+                    catch(...)
+                    {
+                    }
+                    server->stop();
+                }
+
+                if(server_thread.joinable())
+                    server_thread.join();
+
+                tester::bdd::then("The publisher evicted it and its handler returned") =
+                    [events, served, subscribed, publish_seconds] {
+                        check_true(subscribed);
+                        check_eq(events->stats().evicted, std::uint64_t{1});
+                        check_eq(events->subscribers(), std::size_t{0});
+                        check_true(served->load());
+                        // Paced at 1 ms per event; a publish blocked on the
+                        // client would have stalled the loop instead.
+                        check_true(publish_seconds < 10.0);
+                    };
+            };
+        };
+    };
+
     // Regression: custom response headers used to be written after the server's
     // Content-Length / Connection. Echoing the request Content-Length (copy-all
     // headers) produced two CL values — proxies that prefer the last desync.
@@ -2227,6 +2280,469 @@ auto register_server_tests()
         };
     };
 
+    tester::bdd::scenario("Reactor engine serves keep-alive requests on one connection, [net]") = [] {
+        if(not network_tests_enabled()) return;
+        if constexpr(not net::reactor::supported) return;
+
+        using namespace std::chrono_literals;
+        auto server = std::make_shared<http::server>();
+        server->get("/hello").text("hello");
+        server->timeout(std::chrono::seconds{1});
+        server->engine(http::connection_engine::reactor, {.reactor_threads = 2, .worker_threads = 2, .max_pending = 8});
+        check_true(server->engine() == http::connection_engine::reactor);
+
+        auto [t, port, _http_listen_gate] = listen_ephemeral(server);
+        check_true(port != 0);
+
+        auto bodies = std::vector<std::string>{};
+        auto idle = std::optional<net::endpointstream>{};
+        try
+        {
+            // Parked idle connection: must not stop the other client being served.
+            idle = net::connect("127.0.0.1", std::to_string(port));
+            auto stream = net::connect("127.0.0.1", std::to_string(port));
+            for(auto i = 0; i < 3; ++i)
+            {
+                stream << "GET /hello HTTP/1.1" << net::crlf
+                       << "Host: 127.0.0.1" << net::crlf
+                       << net::crlf << net::flush;
+                auto line = ""s;
+                auto length = std::size_t{0};
+                while(std::getline(stream, line) and line != "\r")
+                    if(line.starts_with("Content-Length: "))
+                        length = static_cast<std::size_t>(utils::stoll(utils::trim(line.substr(16))));
+                auto body = std::string(length, '\0');
+                stream.read(body.data(), static_cast<std::streamsize>(length));
+                bodies.push_back(body);
+            }
+        }
+        catch(...)
+        {
+        }
+
+        const auto start = std::chrono::steady_clock::now();
+        server->stop();
+        if(t.joinable())
+            t.join();
+        const auto elapsed = std::chrono::steady_clock::now() - start;
+
+        check_eq(bodies.size(), std::size_t{3});
+        for(const auto& body : bodies)
+            check_eq(body, "hello"s);
+        check_true(elapsed < 2s);
+        idle.reset();
+    };
+
+    tester::bdd::scenario("Reactor engine parks partial requests instead of blocking a worker, [net]") = [] {
+        if(not network_tests_enabled()) return;
+        if constexpr(not net::reactor::supported) return;
+
+        using namespace std::chrono_literals;
+        auto server = std::make_shared<http::server>();
+        server->get("/hello").text("hello");
+        server->post("/echo").response_handler("text/plain", [](std::string_view, std::string_view body, const http::headers&)
+        {
+            return http::make_response("200 OK"s, std::string{body});
+        });
+        server->timeout(std::chrono::seconds{10});
+        server->engine(http::connection_engine::reactor, {.reactor_threads = 1, .worker_threads = 1, .max_pending = 8});
+
+        auto [t, port, _http_listen_gate] = listen_ephemeral(server);
+        check_true(port != 0);
+
+        // Reads one response; empty when none arrives within 2 s.
+        const auto response_body = [](net::endpointstream& stream)
+        {
+            if(not stream.wait_for(2s))
+                return ""s;
+            auto line = ""s;
+            auto length = std::size_t{0};
+            while(std::getline(stream, line) and line != "\r")
+                if(line.starts_with("Content-Length: "))
+                    length = static_cast<std::size_t>(utils::stoll(utils::trim(line.substr(16))));
+            auto body = std::string(length, '\0');
+            stream.read(body.data(), static_cast<std::streamsize>(length));
+            return body;
+        };
+
+        auto fast_bodies = std::vector<std::string>{};
+        auto fast_elapsed = std::chrono::steady_clock::duration::max();
+        auto slow_head = ""s;
+        auto slow_body = ""s;
+        try
+        {
+            // Half a head and half a body: the single worker must not wait for the rest.
+            auto slow_get = net::connect("127.0.0.1", std::to_string(port));
+            slow_get << "GET /hello HTTP/1.1" << net::crlf << "Host: 127." << net::flush;
+            auto slow_post = net::connect("127.0.0.1", std::to_string(port));
+            slow_post << "POST /echo HTTP/1.1" << net::crlf
+                      << "Host: 127.0.0.1" << net::crlf
+                      << "Content-Length: 10" << net::crlf
+                      << net::crlf << "01234" << net::flush;
+            std::this_thread::sleep_for(100ms);
+
+            const auto start = std::chrono::steady_clock::now();
+            auto fast = net::connect("127.0.0.1", std::to_string(port));
+            for(auto i = 0; i < 2; ++i)
+            {
+                fast << "GET /hello HTTP/1.1" << net::crlf
+                     << "Host: 127.0.0.1" << net::crlf
+                     << net::crlf << net::flush;
+                fast_bodies.push_back(response_body(fast));
+            }
+            fast_elapsed = std::chrono::steady_clock::now() - start;
+
+            // The parked requests resume where they stopped.
+            slow_get << "0.0.1" << net::crlf << net::crlf << net::flush;
+            slow_head = response_body(slow_get);
+            slow_post << "56789" << net::flush;
+            slow_body = response_body(slow_post);
+        }
+        catch(...)
+        {
+        }
+
+        server->stop();
+        if(t.joinable())
+            t.join();
+
+        check_eq(fast_bodies.size(), std::size_t{2});
+        for(const auto& body : fast_bodies)
+            check_eq(body, "hello"s);
+        check_true(fast_elapsed < 1s);
+        check_eq(slow_head, "hello"s);
+        check_eq(slow_body, "0123456789"s);
+    };
+
+    tester::bdd::scenario("Reactor engine closes connections idle past the server timeout, [net]") = [] {
+        if(not network_tests_enabled()) return;
+        if constexpr(not net::reactor::supported) return;
+
+        using namespace std::chrono_literals;
+        auto server = std::make_shared<http::server>();
+        server->get("/hello").text("hello");
+        server->timeout(std::chrono::seconds{1});
+        server->engine(http::connection_engine::reactor, {.reactor_threads = 1, .worker_threads = 1, .max_pending = 8});
+
+        auto [t, port, _http_listen_gate] = listen_ephemeral(server);
+        check_true(port != 0);
+
+        auto idle_closed = false;
+        auto idle_elapsed = std::chrono::steady_clock::duration::max();
+        auto active_replies = 0;
+        try
+        {
+            auto idle = net::connect("127.0.0.1", std::to_string(port));
+            auto active = net::connect("127.0.0.1", std::to_string(port));
+            const auto start = std::chrono::steady_clock::now();
+            // Requests every 400 ms keep the other connection open.
+            for(auto i = 0; i < 5; ++i)
+            {
+                active << "GET /hello HTTP/1.1" << net::crlf
+                       << "Host: 127.0.0.1" << net::crlf
+                       << net::crlf << net::flush;
+                auto line = ""s;
+                while(active.wait_for(2s) and std::getline(active, line) and line != "\r")
+                    ;
+                auto body = std::string(5, '\0');
+                active.read(body.data(), 5);
+                active_replies += body == "hello" ? 1 : 0;
+                std::this_thread::sleep_for(400ms);
+            }
+            // EOF: wait_for() is false and the peek that saw it set eofbit.
+            idle_closed = not idle.wait_for(3s) and idle.eof();
+            idle_elapsed = std::chrono::steady_clock::now() - start;
+        }
+        catch(...)
+        {
+        }
+
+        server->stop();
+        if(t.joinable())
+            t.join();
+
+        check_eq(active_replies, 5);
+        check_true(idle_closed);
+        check_true(idle_elapsed < 5s);
+    };
+
+    tester::bdd::scenario("Reactor engine closes a client that stops reading a large response, [net]") = [] {
+        if(not network_tests_enabled()) return;
+        if constexpr(not net::reactor::supported) return;
+
+        using namespace std::chrono_literals;
+        // Far more than the kernel buffers on both ends of a loopback connection.
+        constexpr auto large = std::size_t{64} << 20;
+        auto server = std::make_shared<http::server>();
+        server->get("/hello").text("hello");
+        server->get("/large").response_handler("text/plain", [](std::string_view, std::string_view, const http::headers&)
+        {
+            return http::make_response("200 OK"s, std::string(large, 'x'));
+        });
+        server->timeout(std::chrono::seconds{10});
+        server->engine(http::connection_engine::reactor,
+                       {.reactor_threads = 1, .worker_threads = 1, .max_pending = 8, .write_timeout = 300ms});
+
+        auto [t, port, _http_listen_gate] = listen_ephemeral(server);
+        check_true(port != 0);
+
+        auto fast_body = ""s;
+        auto fast_elapsed = std::chrono::steady_clock::duration::max();
+        auto stuck_bytes = std::size_t{0};
+        auto stuck_closed = false;
+        try
+        {
+            // Asks for the large body and reads none of it, so the single
+            // worker's write stalls once the socket buffers are full.
+            auto stuck = net::connect("127.0.0.1", std::to_string(port));
+            stuck << "GET /large HTTP/1.1" << net::crlf
+                  << "Host: 127.0.0.1" << net::crlf
+                  << net::crlf << net::flush;
+            std::this_thread::sleep_for(100ms);
+
+            const auto start = std::chrono::steady_clock::now();
+            auto fast = net::connect("127.0.0.1", std::to_string(port));
+            fast << "GET /hello HTTP/1.1" << net::crlf
+                 << "Host: 127.0.0.1" << net::crlf
+                 << net::crlf << net::flush;
+            auto line = ""s;
+            while(fast.wait_for(5s) and std::getline(fast, line) and line != "\r")
+                ;
+            fast_body.resize(5);
+            fast.read(fast_body.data(), 5);
+            fast_elapsed = std::chrono::steady_clock::now() - start;
+
+            // What the server sent before it gave up, then EOF.
+            auto chunk = std::string(64 * 1024, '\0');
+            while(stuck.wait_for(2s))
+            {
+                stuck.read(chunk.data(), static_cast<std::streamsize>(chunk.size()));
+                stuck_bytes += static_cast<std::size_t>(stuck.gcount());
+                if(stuck.gcount() == 0)
+                    break;
+                stuck.clear();
+            }
+            stuck_closed = stuck.eof();
+        }
+        catch(...)
+        {
+        }
+
+        server->stop();
+        if(t.joinable())
+            t.join();
+
+        check_eq(fast_body, "hello"s);
+        check_true(fast_elapsed < 5s);
+        check_true(stuck_closed);
+        check_true(stuck_bytes < large);
+    };
+
+    tester::bdd::scenario("Pre-serialized and gathered responses keep their framing, [net]") = [] {
+        if(not network_tests_enabled()) return;
+
+        using namespace std::chrono_literals;
+        auto server = std::make_shared<http::server>();
+        server->get("/static").json(R"({"ok":true})");
+        // Enables HEAD; HEAD /static then falls back to the GET route.
+        server->head("/other").text("other");
+        server->get("/large").response_handler("text/plain", [](std::string_view, std::string_view, const http::headers&)
+        {
+            return http::make_response("200 OK"s, std::string(100'000, 'x'));
+        });
+        server->timeout(std::chrono::seconds{1});
+
+        auto [t, port, _http_listen_gate] = listen_ephemeral(server);
+        check_true(port != 0);
+
+        struct reply { std::string head; std::string body; };
+        auto replies = std::vector<reply>{};
+        try
+        {
+            auto stream = net::connect("127.0.0.1", std::to_string(port));
+            for(const auto& request : {"GET /static"s, "HEAD /static"s, "GET /large"s, "GET /missing"s})
+            {
+                stream << request << " HTTP/1.1" << net::crlf
+                       << "Host: 127.0.0.1" << net::crlf
+                       << net::crlf << net::flush;
+                auto r = reply{};
+                auto line = ""s;
+                auto length = std::size_t{0};
+                while(std::getline(stream, line) and line != "\r")
+                {
+                    r.head += line + "\n";
+                    if(line.starts_with("Content-Length: "))
+                        length = static_cast<std::size_t>(utils::stoll(utils::trim(line.substr(16))));
+                }
+                if(not request.starts_with("HEAD"))
+                {
+                    r.body.resize(length);
+                    stream.read(r.body.data(), static_cast<std::streamsize>(length));
+                }
+                replies.push_back(std::move(r));
+            }
+        }
+        catch(...)
+        {
+        }
+
+        server->stop();
+        if(t.joinable())
+            t.join();
+
+        check_eq(replies.size(), std::size_t{4});
+        if(replies.size() != 4)
+            return;
+        check_contains(replies[0].head, "HTTP/1.1 200 OK");
+        check_contains(replies[0].head, "Content-Type: application/json");
+        check_contains(replies[0].head, "Date: ");
+        check_contains(replies[0].head, "Connection: keep-alive");
+        check_eq(replies[0].body, R"({"ok":true})"s);
+        // HEAD keeps the GET Content-Length but sends no body.
+        check_contains(replies[1].head, "Content-Length: 11");
+        check_eq(replies[2].body, std::string(100'000, 'x'));
+        check_contains(replies[3].head, "404 Not Found");
+    };
+
+    tester::bdd::scenario("Files are served with validators and byte ranges, [net]") = [] {
+        if(not network_tests_enabled()) return;
+
+        const auto root = std::filesystem::temp_directory_path()
+                        / std::format("net_http_files_{}", std::chrono::steady_clock::now().time_since_epoch().count());
+        std::filesystem::create_directories(root / "sub");
+        const auto large = std::string(200'000, 'y') + "END";
+        std::ofstream{root / "index.html"} << "<h1>home</h1>";
+        std::ofstream{root / "sub" / "app.css"} << "body{}";
+        std::ofstream{root / "large.bin", std::ios::binary} << large;
+        std::ofstream{root.parent_path() / "outside.txt"} << "secret";
+
+        auto server = std::make_shared<http::server>();
+        server->files("/static", root.string());
+        server->get("/one").file((root / "sub" / "app.css").string());
+        server->timeout(std::chrono::seconds{1});
+        auto [t, port, _http_listen_gate] = listen_ephemeral(server);
+        check_true(port != 0);
+
+        struct reply { std::string head; std::string body; };
+        auto replies = std::vector<reply>{};
+        auto etag = ""s;
+        try
+        {
+            auto stream = net::connect("127.0.0.1", std::to_string(port));
+            const auto exchange = [&stream](std::string_view target, std::string_view extra)
+            {
+                stream << "GET " << target << " HTTP/1.1" << net::crlf
+                       << "Host: 127.0.0.1" << net::crlf
+                       << extra
+                       << net::crlf << net::flush;
+                auto r = reply{};
+                auto line = ""s;
+                auto length = std::size_t{0};
+                while(std::getline(stream, line) and line != "\r")
+                {
+                    r.head += line + "\n";
+                    if(line.starts_with("Content-Length: "))
+                        length = static_cast<std::size_t>(utils::stoll(utils::trim(line.substr(16))));
+                }
+                r.body.resize(length);
+                stream.read(r.body.data(), static_cast<std::streamsize>(length));
+                return r;
+            };
+
+            replies.push_back(exchange("/static/", ""));
+            replies.push_back(exchange("/static/sub/app.css", ""));
+            if(const auto at = replies.back().head.find("ETag: "); at != std::string::npos)
+                etag = replies.back().head.substr(at + 6, replies.back().head.find('\r', at) - at - 6);
+            replies.push_back(exchange("/static/sub/app.css", "If-None-Match: " + etag + "\r\n"));
+            replies.push_back(exchange("/static/large.bin", ""));
+            replies.push_back(exchange("/static/large.bin", "Range: bytes=-3\r\n"));
+            replies.push_back(exchange("/static/large.bin", "Range: bytes=999999-\r\n"));
+            replies.push_back(exchange("/static/%2e%2e/outside.txt", ""));
+            replies.push_back(exchange("/one", ""));
+        }
+        catch(...)
+        {
+        }
+
+        server->stop();
+        if(t.joinable())
+            t.join();
+        auto ec = std::error_code{};
+        std::filesystem::remove_all(root, ec);
+        std::filesystem::remove(root.parent_path() / "outside.txt", ec);
+
+        check_eq(replies.size(), std::size_t{8});
+        if(replies.size() != 8)
+            return;
+        check_eq(replies[0].body, "<h1>home</h1>"s);
+        check_contains(replies[0].head, "Content-Type: text/html");
+        check_contains(replies[1].head, "Accept-Ranges: bytes");
+        check_eq(replies[1].body, "body{}"s);
+        check_false(etag.empty());
+        check_contains(replies[2].head, "304 Not Modified");
+        check_true(replies[2].body.empty());
+        // Above the mapping limit: head, then the body via sendfile.
+        check_eq(replies[3].body, large);
+        check_contains(replies[4].head, "206 Partial Content");
+        check_contains(replies[4].head, std::format("Content-Range: bytes {}-{}/{}", large.size() - 3, large.size() - 1, large.size()));
+        check_eq(replies[4].body, "END"s);
+        check_contains(replies[5].head, "416 Range Not Satisfiable");
+        check_contains(replies[5].head, std::format("Content-Range: bytes */{}", large.size()));
+        check_contains(replies[6].head, "404 Not Found");
+        check_eq(replies[7].body, "body{}"s);
+    };
+
+    tester::bdd::scenario("Pipelined requests are answered in order in one batch, [net]") = [] {
+        if(not network_tests_enabled()) return;
+
+        auto server = std::make_shared<http::server>();
+        server->get("/a").text("first");
+        server->get("/b").response_handler("text/plain", [](std::string_view, std::string_view, const http::headers&)
+        {
+            return http::make_response("200 OK"s, "second"s);
+        });
+        server->timeout(std::chrono::seconds{1});
+        auto [t, port, _http_listen_gate] = listen_ephemeral(server);
+        check_true(port != 0);
+
+        auto bodies = std::vector<std::string>{};
+        try
+        {
+            auto stream = net::connect("127.0.0.1", std::to_string(port));
+            // All requests in one segment: the server finds them buffered.
+            for(const auto target : {"/a"sv, "/b"sv, "/missing"sv, "/a"sv})
+                stream << "GET " << target << " HTTP/1.1" << net::crlf
+                       << "Host: 127.0.0.1" << net::crlf << net::crlf;
+            stream << net::flush;
+
+            for(auto i = 0; i < 4; ++i)
+            {
+                auto line = ""s;
+                auto status = ""s;
+                auto length = std::size_t{0};
+                while(std::getline(stream, line) and line != "\r")
+                {
+                    if(status.empty())
+                        status = line;
+                    if(line.starts_with("Content-Length: "))
+                        length = static_cast<std::size_t>(utils::stoll(utils::trim(line.substr(16))));
+                }
+                auto body = std::string(length, '\0');
+                stream.read(body.data(), static_cast<std::streamsize>(length));
+                bodies.push_back(status.substr(9, 3) + ":" + body);
+            }
+        }
+        catch(...)
+        {
+        }
+
+        server->stop();
+        if(t.joinable())
+            t.join();
+
+        check_eq(bodies, std::vector{"200:first"s, "200:second"s, "404:"s, "200:first"s});
+    };
+
     return true;
 }
 
@@ -0,0 +1,338 @@
+// Copyright (c) 2025-2026 Kaius Ruokonen. All rights reserved.
+// SPDX-License-Identifier: MIT
+// See the LICENSE file in the project root for full license text.
+
+// HTTP server benchmarks. Hidden behind [.benchmark] so the [net] suite and CI
+// never run them; select explicitly:
+//   tools/CB.sh release test --tags='\[\.benchmark\]'
+// Results go to std::clog, one line per measurement.
+
+module net;
+import :posix;
+import :reactor;
+import tester;
+import std;
+
+using namespace net;
+
+namespace {
+using namespace std::string_literals;
+using namespace std::string_view_literals;
+using tester::assertions::check_true;
+using tester::assertions::warning;
+
+// VmRSS from /proc/self/status in KiB (0 where procfs is unavailable).
+inline long long resident_kib()
+{
+    auto status = std::ifstream{"/proc/self/status"};
+    auto line = ""s;
+    while(std::getline(status, line))
+        if(line.starts_with("VmRSS:"))
+            return utils::stoll(utils::trim(std::string_view{line}.substr(6, line.find(" kB") - 6)));
+    return 0;
+}
+
+// Raise RLIMIT_NOFILE towards `wanted`; returns the soft limit in effect.
+inline std::size_t raise_fd_limit(std::size_t wanted)
+{
+    auto limit = posix::rlimit{};
+    if(posix::getrlimit(posix::rlimit_nofile, &limit) != 0)
+        return 0;
+    if(limit.rlim_cur < wanted)
+    {
+        limit.rlim_cur = std::min<decltype(limit.rlim_cur)>(wanted, limit.rlim_max);
+        posix::setrlimit(posix::rlimit_nofile, &limit);
+        posix::getrlimit(posix::rlimit_nofile, &limit);
+    }
+    return static_cast<std::size_t>(limit.rlim_cur);
+}
+
+// Quiet slog for the duration of a benchmark; threads started meanwhile
+// inherit the level from the process defaults.
+struct quiet_slog
+{
+    quiet_slog() : previous{slog.log_level()} { slog.log_level(syslog::severity::error); }
+    ~quiet_slog() { slog.log_level(previous); }
+    syslog::severity previous;
+};
+
+struct running_server
+{
+    std::shared_ptr<http::server> server;
+    std::thread thread;
+    std::uint16_t port = 0;
+
+    ~running_server()
+    {
+        server->stop();
+        if(thread.joinable())
+            thread.join();
+    }
+};
+
+inline std::unique_ptr<running_server> start(std::shared_ptr<http::server> server)
+{
+    using namespace std::chrono_literals;
+    auto running = std::make_unique<running_server>();
+    running->server = std::move(server);
+    auto bound = std::make_shared<std::promise<std::uint16_t>>();
+    auto port = bound->get_future();
+    running->thread = std::thread{[s = running->server, bound]
+    {
+        try
+        {
+            s->listen("127.0.0.1", "0", [s, bound]{ bound->set_value(s->bound_port()); });
+        }
+        catch(...)
+        {
+            try { bound->set_value(0); } catch(...) {}
+        }
+    }};
+    if(port.wait_for(5s) == std::future_status::ready)
+        running->port = port.get();
+    return running;
+}
+
+// Send one keep-alive GET and consume the response. False on any I/O failure.
+inline bool round_trip(net::endpointstream& stream, std::string_view request)
+{
+    stream.write(request.data(), static_cast<std::streamsize>(request.size()));
+    stream.flush();
+    auto line = ""s;
+    auto length = 0ll;
+    while(std::getline(stream, line) and line != "\r")
+        if(line.starts_with("Content-Length: "))
+            length = utils::stoll(utils::trim(std::string_view{line}.substr(16)));
+    if(not stream)
+        return false;
+    stream.ignore(length);
+    return static_cast<bool>(stream);
+}
+
+// Send `depth` copies of `request` in one write, then consume every response.
+inline bool pipelined_batch(net::endpointstream& stream, std::string_view request, std::size_t depth)
+{
+    thread_local auto batch = std::string{};
+    batch.clear();
+    for(auto i = std::size_t{0}; i < depth; ++i)
+        batch.append(request);
+    stream.write(batch.data(), static_cast<std::streamsize>(batch.size()));
+    stream.flush();
+    auto line = ""s;
+    for(auto i = std::size_t{0}; i < depth; ++i)
+    {
+        auto length = 0ll;
+        while(std::getline(stream, line) and line != "\r")
+            if(line.starts_with("Content-Length: "))
+                length = utils::stoll(utils::trim(std::string_view{line}.substr(16)));
+        if(not stream)
+            return false;
+        stream.ignore(length);
+    }
+    return static_cast<bool>(stream);
+}
+
+// Requests per second over `duration` from `clients` keep-alive connections.
+inline double measure_rps(std::uint16_t port, std::size_t clients, std::chrono::milliseconds duration, std::string_view path = "/ping")
+{
+    const auto request = std::format("GET {} HTTP/1.1\r\nHost: 127.0.0.1\r\n\r\n", path);
+    auto total = std::atomic<long long>{0};
+    auto threads = std::vector<std::thread>{};
+    const auto deadline = std::chrono::steady_clock::now() + duration;
+    for(auto i = std::size_t{0}; i < clients; ++i)
+    {
+        threads.emplace_back([&]
+        {
+            try
+            {
+                auto stream = net::connect("127.0.0.1", std::to_string(port));
+                auto n = 0ll;
+                while(std::chrono::steady_clock::now() < deadline and round_trip(stream, request))
+                    ++n;
+                total.fetch_add(n);
+            }
+            catch(...)
+            {
+            }
+        });
+    }
+    for(auto& t : threads)
+        t.join();
+    return static_cast<double>(total.load()) / std::chrono::duration<double>(duration).count();
+}
+
+} // namespace
+
+auto register_http_server_benchmarks()
+{
+    tester::bdd::scenario("Connection engines at 10k idle keep-alive connections, [.benchmark]") = [] {
+        using namespace std::chrono_literals;
+        const auto quiet = quiet_slog{};
+
+        constexpr auto wanted_idle = std::size_t{10'000};
+        // Client and server ends both live in this process.
+        const auto fd_limit = raise_fd_limit(2 * wanted_idle + 512);
+        const auto idle_count = std::min(wanted_idle, fd_limit > 512 ? (fd_limit - 512) / 2 : 0);
+        if(idle_count < wanted_idle)
+            warning("RLIMIT_NOFILE too low for 10k idle connections; running with fewer");
+
+        for(const auto engine : {http::connection_engine::thread_per_connection, http::connection_engine::reactor})
+        {
+            if(engine == http::connection_engine::reactor and not net::reactor::supported)
+                continue;
+
+            auto server = std::make_shared<http::server>();
+            server->get("/ping").text("pong");
+            server->engine(engine);
+            const auto rss_before = resident_kib();
+            auto running = start(server);
+            check_true(running->port != 0);
+            if(running->port == 0)
+                return;
+
+            auto idle = std::vector<net::endpointstream>{};
+            idle.reserve(idle_count);
+            for(auto i = std::size_t{0}; i < idle_count; ++i)
+            {
+                try
+                {
+                    idle.push_back(net::connect("127.0.0.1", std::to_string(running->port)));
+                }
+                catch(...)
+                {
+                    break;
+                }
+            }
+            // Let the server accept (and, for threads, spawn) every connection.
+            std::this_thread::sleep_for(1s);
+            const auto rss_idle = resident_kib();
+
+            const auto rps = measure_rps(running->port, 16, 3s);
+
+            std::clog << std::format(
+                "engine={} idle_connections={} requests_per_second={:.0f} rss_delta_mib={:.1f}\n",
+                engine == http::connection_engine::reactor ? "reactor"sv : "thread_per_connection"sv,
+                idle.size(),
+                rps,
+                static_cast<double>(rss_idle - rss_before) / 1024.0);
+
+            idle.clear();
+            running.reset();
+        }
+    };
+
+    tester::bdd::scenario("Response throughput by body size, [.benchmark]") = [] {
+        using namespace std::chrono_literals;
+        const auto quiet = quiet_slog{};
+
+        auto server = std::make_shared<http::server>();
+        constexpr auto sizes = std::array{std::size_t{100}, std::size_t{10 * 1024}, std::size_t{1024 * 1024}};
+        for(const auto size : sizes)
+        {
+            const auto body = std::string(size, 'x');
+            // Pre-serialized at registration vs built by a handler per request.
+            server->get(std::format("/static/{}", size)).text(body);
+            server->get(std::format("/dynamic/{}", size)).response_handler("text/plain", [body](auto&&...)
+            {
+                return http::make_response(http::status_ok, body);
+            });
+        }
+        auto running = start(server);
+        check_true(running->port != 0);
+        if(running->port == 0)
+            return;
+
+        for(const auto size : sizes)
+            for(const auto kind : {"static"sv, "dynamic"sv})
+            {
+                const auto rps = measure_rps(running->port, 4, 2s, std::format("/{}/{}", kind, size));
+                std::clog << std::format("body_bytes={} route={} requests_per_second={:.0f} mib_per_second={:.1f}\n",
+                                         size, kind, rps, rps * static_cast<double>(size) / (1024.0 * 1024.0));
+            }
+    };
+
+    tester::bdd::scenario("File routes vs string bodies, [.benchmark]") = [] {
+        using namespace std::chrono_literals;
+        const auto quiet = quiet_slog{};
+
+        const auto root = std::filesystem::temp_directory_path()
+                        / std::format("net_http_bench_{}", std::chrono::steady_clock::now().time_since_epoch().count());
+        std::filesystem::create_directories(root);
+        auto server = std::make_shared<http::server>();
+        // 4 KiB and 64 KiB are mapped (writev), 1 MiB goes out with sendfile.
+        constexpr auto sizes = std::array{std::size_t{4 * 1024}, std::size_t{64 * 1024}, std::size_t{1024 * 1024}};
+        for(const auto size : sizes)
+        {
+            const auto body = std::string(size, 'x');
+            std::ofstream{root / std::format("{}.bin", size), std::ios::binary} << body;
+            server->get(std::format("/string/{}", size)).response_handler("application/octet-stream", [body](auto&&...)
+            {
+                return http::make_response(http::status_ok, body);
+            });
+        }
+        server->files("/file", root.string());
+        auto running = start(server);
+        check_true(running->port != 0);
+
+        for(const auto size : sizes)
+            for(const auto kind : {"string"sv, "file"sv})
+            {
+                if(running->port == 0)
+                    break;
+                const auto path = kind == "file"sv ? std::format("/file/{}.bin", size) : std::format("/string/{}", size);
+                const auto rps = measure_rps(running->port, 4, 2s, path);
+                std::clog << std::format("body_bytes={} route={} requests_per_second={:.0f} mib_per_second={:.1f}\n",
+                                         size, kind, rps, rps * static_cast<double>(size) / (1024.0 * 1024.0));
+            }
+
+        running.reset();
+        auto ec = std::error_code{};
+        std::filesystem::remove_all(root, ec);
+    };
+
+    tester::bdd::scenario("Pipelined GET latency by depth, [.benchmark]") = [] {
+        using namespace std::chrono;
+        const auto quiet = quiet_slog{};
+
+        auto server = std::make_shared<http::server>();
+        server->get("/ping").text("pong");
+        auto running = start(server);
+        check_true(running->port != 0);
+        if(running->port == 0)
+            return;
+
+        const auto request = "GET /ping HTTP/1.1\r\nHost: 127.0.0.1\r\n\r\n"sv;
+        try
+        {
+            auto stream = net::connect("127.0.0.1", std::to_string(running->port));
+            for(const auto depth : {std::size_t{1}, std::size_t{8}, std::size_t{32}})
+            {
+                // depth=1 is the sequential round trip every request paid before.
+                constexpr auto batches = 2'000;
+                auto samples = std::vector<double>{};
+                samples.reserve(batches);
+                for(auto i = 0; i < batches; ++i)
+                {
+                    const auto begin = steady_clock::now();
+                    if(not pipelined_batch(stream, request, depth))
+                        break;
+                    samples.push_back(duration<double, std::micro>(steady_clock::now() - begin).count());
+                }
+                if(samples.empty())
+                    break;
+                std::ranges::sort(samples);
+                const auto p50 = samples[samples.size() / 2];
+                const auto p99 = samples[samples.size() * 99 / 100];
+                std::clog << std::format("depth={} batch_p50_us={:.1f} batch_p99_us={:.1f} per_request_us={:.2f}\n",
+                                         depth, p50, p99, p50 / static_cast<double>(depth));
+            }
+        }
+        catch(...)
+        {
+        }
+    };
+
+    return true;
+}
+
+const auto _ = register_http_server_benchmarks();
@@ -19,6 +19,56 @@ using tester::assertions::check_false;
 using tester::assertions::check_contains;
 using tester::assertions::check_nothrow;
 
+// The metrics registry before sharding: one mutex, four strings per key and
+// sorted flat_map inserts — the baseline for the contention benchmark.
+struct global_lock_registry
+{
+    struct series
+    {
+        std::array<std::uint64_t, http::middleware::http_metrics_histogram_bounds.size()> buckets{};
+        double sum = 0.0;
+        std::uint64_t count = 0;
+    };
+
+    void observe(std::string_view method, std::string_view status, std::string_view path, std::string_view scenario, double seconds)
+    {
+        auto key = http::middleware::metrics_label_key{std::string{method}, std::string{status}, std::string{path}, std::string{scenario}};
+        std::lock_guard lock{mutex};
+        ++totals[key];
+        auto& s = durations[key];
+        for(auto i = std::size_t{0}; i < s.buckets.size(); ++i)
+            if(seconds <= http::middleware::http_metrics_histogram_bounds[i])
+                ++s.buckets[i];
+        s.sum += seconds;
+        ++s.count;
+    }
+
+    std::mutex mutex;
+    std::flat_map<http::middleware::metrics_label_key, std::uint64_t> totals;
+    std::flat_map<http::middleware::metrics_label_key, series> durations;
+};
+
+// Wall time for `threads` threads to make `total` calls of `call(thread, i)`
+// between them, all released at once.
+inline double contended_seconds(std::size_t threads, std::size_t total, auto call)
+{
+    auto go = std::atomic<bool>{false};
+    auto workers = std::vector<std::thread>{};
+    for(auto t = std::size_t{0}; t < threads; ++t)
+        workers.emplace_back([&go, &call, t, n = total / threads]
+        {
+            while(not go.load(std::memory_order_acquire))
+                std::this_thread::yield();
+            for(auto i = std::size_t{0}; i < n; ++i)
+                call(t, i);
+        });
+    const auto begin = std::chrono::steady_clock::now();
+    go.store(true, std::memory_order_release);
+    for(auto& w : workers)
+        w.join();
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+}
+
 } // namespace
 
 auto register_middleware_tests()
@@ -1099,6 +1149,103 @@ auto register_middleware_tests()
         };
     };
 
+    tester::bdd::scenario("rate_limiter - keeps constant state per key and forgets idle keys, [net]") = [] {
+        auto limiter = ::http::middleware::rate_limiter{};
+        check_true(limiter.check_limit("a"sv, 2, 60s));
+        check_true(limiter.check_limit("a"sv, 2, 60s));
+        check_false(limiter.check_limit("a"sv, 2, 60s));
+        check_true(limiter.check_limit("b"sv, 2, 60s));
+        check_eq(limiter.size(), std::size_t{2});
+
+        // A zero window rolls over on every call, so spam keys go idle at
+        // once and are swept while new ones arrive.
+        auto spam = ::http::middleware::rate_limiter{};
+        for(auto i = 0; i < 10'000; ++i)
+            (void)spam.check_limit(std::to_string(i), 1, 0s);
+        check_true(spam.size() < std::size_t{1'000});
+    };
+
+    tester::bdd::scenario("metrics_registry - merges per-thread shards on render, [net]") = [] {
+        auto registry = ::http::middleware::metrics_registry{};
+        constexpr auto threads = 8;
+        constexpr auto per_thread = 10'000;
+        auto workers = std::vector<std::thread>{};
+        for(auto t = 0; t < threads; ++t)
+            workers.emplace_back([&registry, t]
+            {
+                for(auto i = 0; i < per_thread; ++i)
+                    registry.observe("GET"sv, "200"sv, i % 2 == 0 ? "/even"sv : "/odd"sv, t % 2 == 0 ? "-"sv : "x"sv, 0.003);
+            });
+        // Scrapes racing the writers must not disturb them.
+        for(auto i = 0; i < 10; ++i)
+            (void)registry.render_prometheus_text();
+        for(auto& w : workers)
+            w.join();
+
+        // Threads that come and go reuse the shards of exited ones.
+        for(auto i = 0; i < 20; ++i)
+            std::thread{[&registry]{ registry.observe("GET"sv, "200"sv, "/short"sv, "-"sv, 0.003); }}.join();
+
+        const auto body = registry.render_prometheus_text();
+        check_contains(body, R"(http_requests_total{method="GET",status="200",path="/even",scenario="-"} 20000)");
+        check_contains(body, R"(http_requests_total{method="GET",status="200",path="/odd",scenario="x"} 20000)");
+        check_contains(body, R"(http_requests_total{method="GET",status="200",path="/short",scenario="-"} 20)");
+        check_contains(body, R"(http_request_duration_seconds_bucket{method="GET",status="200",path="/even",scenario="-",le="0.0025"} 0)");
+        check_contains(body, R"(http_request_duration_seconds_bucket{method="GET",status="200",path="/even",scenario="-",le="0.005"} 20000)");
+
+        registry.reset();
+        check_true(registry.render_prometheus_text().find("http_requests_total{") == std::string::npos);
+        registry.observe("GET"sv, "200"sv, "/after"sv, "-"sv, 0.003);
+        check_contains(registry.render_prometheus_text(), R"(path="/after",scenario="-"} 1)");
+    };
+
+    // Hidden behind [.benchmark]; select with --tags='\[\.benchmark\]'.
+    tester::bdd::scenario("Metrics and rate limiter under contention, [.benchmark]") = [] {
+        constexpr auto total = std::size_t{1'000'000};
+        constexpr auto paths = std::array{"/users"sv, "/users/{id}"sv, "/orders"sv, "/health"sv};
+        constexpr auto statuses = std::array{"200"sv, "201"sv, "404"sv, "500"sv};
+        const auto keys = []
+        {
+            auto k = std::vector<std::string>{};
+            for(auto i = 0; i < 1024; ++i)
+                k.push_back(std::format("10.0.{}.{}", i / 256, i % 256));
+            return k;
+        }();
+
+        for(const auto threads : {std::size_t{1}, std::size_t{2}, std::size_t{4}, std::size_t{8}, std::size_t{16}, std::size_t{32}})
+        {
+            auto baseline = global_lock_registry{};
+            const auto locked = contended_seconds(threads, total, [&baseline, &paths, &statuses](std::size_t, std::size_t i)
+            {
+                baseline.observe("GET"sv, statuses[i % statuses.size()], paths[i % paths.size()], "-"sv, 0.0005);
+            });
+
+            auto registry = http::middleware::metrics_registry{};
+            const auto sharded = contended_seconds(threads, total, [&registry, &paths, &statuses](std::size_t, std::size_t i)
+            {
+                registry.observe("GET"sv, statuses[i % statuses.size()], paths[i % paths.size()], "-"sv, 0.0005);
+            });
+            const auto render_begin = std::chrono::steady_clock::now();
+            const auto text = registry.render_prometheus_text();
+            const auto render_us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - render_begin).count();
+
+            auto limiter = http::middleware::rate_limiter{};
+            const auto limited = contended_seconds(threads, total, [&limiter, &keys](std::size_t t, std::size_t i)
+            {
+                (void)limiter.check_limit(keys[(t * 131 + i) % keys.size()], 1'000'000, std::chrono::seconds{60});
+            });
+
+            std::clog << std::format("threads={} observations={} global_lock_ns_per_op={:.1f} sharded_ns_per_op={:.1f} "
+                                     "render_us={:.0f} render_bytes={} rate_limiter_ns_per_op={:.1f} rate_limiter_keys={}\n",
+                                     threads, total,
+                                     locked * 1e9 / static_cast<double>(total),
+                                     sharded * 1e9 / static_cast<double>(total),
+                                     render_us, text.size(),
+                                     limited * 1e9 / static_cast<double>(total),
+                                     limiter.size());
+        }
+    };
+
     return true;
 }
 
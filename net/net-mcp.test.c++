@@ -102,9 +102,11 @@ private:
 };
 
 // Bind 127.0.0.1:0 and return {server_thread, bound_port}. Port 0 means bind failed.
-inline std::pair<joining_server_thread, std::uint16_t> listen_ephemeral(const std::shared_ptr<http::server>& server)
+inline std::tuple<joining_server_thread, std::uint16_t, std::shared_ptr<std::unique_lock<std::recursive_mutex>>>
+listen_ephemeral(const std::shared_ptr<http::server>& server)
 {
     using namespace std::chrono_literals;
+    auto gate = std::make_shared<std::unique_lock<std::recursive_mutex>>(net::test::slog_capture_mutex());
     auto port = std::make_shared<std::uint16_t>(0);
     auto bound = std::make_shared<std::promise<void>>();
     auto bound_future = bound->get_future();
@@ -124,8 +126,8 @@ inline std::pair<joining_server_thread, std::uint16_t> listen_ephemeral(const st
         }
     }};
     if(bound_future.wait_for(2s) != std::future_status::ready)
-        return {joining_server_thread{server, std::move(t)}, 0};
-    return {joining_server_thread{server, std::move(t)}, *port};
+        return {joining_server_thread{server, std::move(t)}, 0, std::move(gate)};
+    return {joining_server_thread{server, std::move(t)}, *port, std::move(gate)};
 }
 
 // Parse `event:` / `data:` pairs from an SSE body (v1 subset).
@@ -261,7 +263,7 @@ auto register_mcp_tests()
             });
             server->timeout(std::chrono::seconds{1});
 
-            auto [server_thread, port] = listen_ephemeral(server);
+            auto [server_thread, port, _http_listen_gate] = listen_ephemeral(server);
             const auto port_s = std::to_string(port);
 
             auto endpoint_data = ""s;
@@ -388,7 +390,7 @@ auto register_mcp_tests()
             });
             server->timeout(std::chrono::seconds{1});
 
-            auto [server_thread, port] = listen_ephemeral(server);
+            auto [server_thread, port, _http_listen_gate] = listen_ephemeral(server);
             const auto port_s = std::to_string(port);
 
             auto endpoint_data = ""s;
@@ -492,7 +494,7 @@ auto register_mcp_tests()
             });
             server->timeout(std::chrono::seconds{1});
 
-            auto [server_thread, port] = listen_ephemeral(server);
+            auto [server_thread, port, _http_listen_gate] = listen_ephemeral(server);
             const auto port_s = std::to_string(port);
 
             auto endpoint_data = ""s;
@@ -853,6 +855,31 @@ auto register_mcp_tests()
             check_eq(*called, "ping"s);
         };
 
+        section("JSON member scan: top-level fields from one pass") = []
+        {
+            const auto members = detail::json_members{
+                R"({"a":1,"b":2,"c":3,"d":4,"e":5,"f":6,"g":7,"h":8,)"
+                R"("method":"tools/call","\u0069d":"x\"y","params":{"id":0,"name":"echo","arguments":{"s":"}"}}})"};
+            check_eq(members.string_field("method"sv).value_or(""sv), "tools/call"sv);
+            check_eq(members.id_field().value_or(""s), R"("x\"y")"s);
+            const auto params = members.object_field("params"sv);
+            require_true(params.has_value());
+            check_eq(*params, R"({"id":0,"name":"echo","arguments":{"s":"}"}})"sv);
+            check_eq(detail::json_members{*params}.object_field("arguments"sv).value_or(""sv), R"({"s":"}"})"sv);
+            check_false(members.value("name"sv).has_value());
+
+            // Duplicates past the inline member slots still fail closed.
+            const auto spilled = detail::json_members{
+                R"({"a":1,"b":2,"c":3,"d":4,"e":5,"f":6,"g":7,"h":8,"method":"ping","method":"tools/call"})"};
+            check_false(spilled.string_field("method"sv).has_value());
+            check_eq(spilled.value("h"sv).value_or(""sv).substr(0, 1), "8"sv);
+
+            // A body failing the scan answers every lookup with nullopt.
+            const auto twin = detail::json_members{R"({"method":"ping"} {"id":1})"};
+            check_false(twin.string_field("method"sv).has_value());
+            check_false(twin.id_field().has_value());
+        };
+
         section("Host/Origin allow patterns") = []
         {
             check_true(match_allow_pattern("127.0.0.1:8101", "127.0.0.1:*"));
@@ -876,7 +903,7 @@ auto register_mcp_tests()
             mcp->attach(*http, "/sse");
             http->timeout(std::chrono::seconds{1});
 
-            auto [server_thread, port] = listen_ephemeral(http);
+            auto [server_thread, port, _http_listen_gate] = listen_ephemeral(http);
             const auto port_s = std::to_string(port);
 
             auto saw_endpoint = false;
@@ -961,7 +988,7 @@ auto register_mcp_tests()
             mcp->attach(*http, "/sse");
             http->timeout(std::chrono::seconds{1});
 
-            auto [server_thread, port] = listen_ephemeral(http);
+            auto [server_thread, port, _http_listen_gate] = listen_ephemeral(http);
             const auto port_s = std::to_string(port);
 
             auto init_reply = ""s;
@@ -1101,7 +1128,7 @@ auto register_mcp_tests()
             mcp->attach(*http, "/sse");
             http->timeout(std::chrono::seconds{1});
 
-            auto [server_thread, port] = listen_ephemeral(http);
+            auto [server_thread, port, _http_listen_gate] = listen_ephemeral(http);
             const auto port_s = std::to_string(port);
 
             auto denied_status = ""s;
@@ -1188,6 +1215,64 @@ auto register_mcp_tests()
         };
     };
 
+    // Hidden behind [.benchmark]; select with --tags='\[\.benchmark\]'.
+    test_case("MCP request parse cost by body size, [.benchmark]") = [] {
+        const auto info = server_info{};
+        const auto list = list_tools_fn{};
+        const auto call = call_tool_fn{[](std::string_view, std::string_view arguments) {
+            return tool_result{.text = std::string{arguments.substr(0, 8)}};
+        }};
+
+        for(const auto size : {std::size_t{64}, std::size_t{1024}, std::size_t{16 * 1024},
+                                std::size_t{256 * 1024}, std::size_t{1024 * 1024}})
+        {
+            const auto body = R"({"jsonrpc":"2.0","id":7,"method":"tools/call","params":{"name":"echo","arguments":{"text":")"s
+                + std::string(size, 'x') + R"("}}})"s;
+            const auto rounds = std::clamp<std::size_t>((std::size_t{256} << 20) / body.size(), 16, 200'000);
+            auto found = std::size_t{0};
+
+            // The former lookups: every field rescans the whole body.
+            auto begin = std::chrono::steady_clock::now();
+            for(auto r = std::size_t{0}; r < rounds; ++r)
+            {
+                const auto method = detail::json_string_field(body, "method"sv);
+                const auto id = detail::json_id_field(body);
+                const auto params = detail::json_object_field(body, "params"sv).value_or("{}"sv);
+                const auto name = detail::json_string_field(params, "name"sv);
+                const auto arguments = detail::json_object_field(params, "arguments"sv);
+                found += method and id and name and arguments ? 1 : 0;
+            }
+            const auto per_field_s = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+
+            // One member scan of the body, then one of params.
+            begin = std::chrono::steady_clock::now();
+            for(auto r = std::size_t{0}; r < rounds; ++r)
+            {
+                const auto members = detail::json_members{body};
+                const auto method = members.string_field("method"sv);
+                const auto id = members.id_field();
+                const auto params = detail::json_members{members.object_field("params"sv).value_or("{}"sv)};
+                const auto name = params.string_field("name"sv);
+                const auto arguments = params.object_field("arguments"sv);
+                found += method and id and name and arguments ? 1 : 0;
+            }
+            const auto one_pass_s = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+
+            begin = std::chrono::steady_clock::now();
+            for(auto r = std::size_t{0}; r < rounds; ++r)
+                found += handle_json_rpc(body, info, list, call) ? 1 : 0;
+            const auto dispatch_s = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+
+            check_true(found == 3 * rounds);
+            const auto per_request_ns = [rounds](double seconds) { return seconds * 1e9 / static_cast<double>(rounds); };
+            std::clog << std::format("mcp body_bytes={} per_field_ns={:.0f} one_pass_ns={:.0f} dispatch_ns={:.0f} "
+                                     "one_pass_mb_per_s={:.0f}\n",
+                                     body.size(), per_request_ns(per_field_s), per_request_ns(one_pass_s),
+                                     per_request_ns(dispatch_s),
+                                     static_cast<double>(body.size()) * static_cast<double>(rounds) / one_pass_s / 1e6);
+        }
+    };
+
     return true;
 }
 
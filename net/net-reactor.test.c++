@@ -0,0 +1,156 @@
+// Copyright (c) 2025-2026 Kaius Ruokonen. All rights reserved.
+// SPDX-License-Identifier: MIT
+// See the LICENSE file in the project root for full license text.
+
+module net;
+import :posix;
+import :reactor;
+import :socket;
+import tester;
+import std;
+
+using namespace net;
+
+namespace {
+using tester::assertions::check_eq;
+using tester::assertions::check_true;
+using tester::assertions::check_false;
+}
+
+auto register_reactor_tests()
+{
+    tester::bdd::scenario("Worker pool runs every submitted job, [net]") = [] {
+        tester::bdd::given("A pool of 4 workers with a queue of 2") = [] {
+            auto done = std::atomic<int>{0};
+            {
+                auto pool = net::worker_pool{4, 2};
+                check_eq(pool.size(), std::size_t{4});
+                check_eq(pool.capacity(), std::size_t{2});
+                for(auto i = 0; i < 100; ++i)
+                    pool.submit([&done]{ done.fetch_add(1); });
+            }
+            tester::bdd::then("Destruction drains the queue before joining") = [n = done.load()] {
+                check_eq(n, 100);
+            };
+        };
+
+        tester::bdd::given("A job that throws") = [] {
+            auto done = std::atomic<int>{0};
+            {
+                auto pool = net::worker_pool{1, 4};
+                pool.submit([]{ throw std::runtime_error{"boom"}; });
+                pool.submit([&done]{ done.fetch_add(1); });
+            }
+            tester::bdd::then("The worker survives and runs the next job") = [n = done.load()] {
+                check_eq(n, 1);
+            };
+        };
+    };
+
+    tester::bdd::scenario("Reactor delivers one event per watch, [net]") = [] {
+        if constexpr(not net::reactor::supported) return;
+
+        using namespace std::chrono_literals;
+        int fds[2]{-1, -1};
+        check_eq(posix::pipe(fds), 0);
+        const auto r = net::socket{fds[0]};
+        const auto w = net::socket{fds[1]};
+
+        auto mutex = std::mutex{};
+        auto cv = std::condition_variable{};
+        auto events = 0;
+        auto context = 42;
+        void* seen = nullptr;
+
+        auto rx = net::reactor{[&](void* ctx)
+        {
+            std::lock_guard lock{mutex};
+            seen = ctx;
+            ++events;
+            cv.notify_all();
+        }};
+        check_true(rx.watch(r, &context));
+
+        const char byte = 'x';
+        check_eq(posix::write(w, &byte, 1), 1l);
+
+        {
+            std::unique_lock lock{mutex};
+            check_true(cv.wait_for(lock, 2s, [&]{ return events == 1; }));
+            check_true(seen == &context);
+        }
+
+        // Still readable, but one-shot: nothing more until re-armed.
+        std::this_thread::sleep_for(50ms);
+        {
+            std::lock_guard lock{mutex};
+            check_eq(events, 1);
+        }
+
+        check_true(rx.watch(r, &context));
+        {
+            std::unique_lock lock{mutex};
+            check_true(cv.wait_for(lock, 2s, [&]{ return events == 2; }));
+        }
+
+        rx.forget(r);
+        check_false(events > 2);
+    };
+
+    tester::bdd::scenario("Reactor expires fds armed past the idle timeout, [net]") = [] {
+        if constexpr(not net::reactor::supported) return;
+
+        using namespace std::chrono_literals;
+        int quiet[2]{-1, -1};
+        int busy[2]{-1, -1};
+        check_eq(posix::pipe(quiet), 0);
+        check_eq(posix::pipe(busy), 0);
+        const auto quiet_r = net::socket{quiet[0]};
+        const auto quiet_w = net::socket{quiet[1]};
+        const auto busy_r = net::socket{busy[0]};
+        const auto busy_w = net::socket{busy[1]};
+
+        auto mutex = std::mutex{};
+        auto cv = std::condition_variable{};
+        auto ready = std::vector<void*>{};
+        auto idle = std::vector<void*>{};
+        auto quiet_context = 1;
+        auto busy_context = 2;
+
+        auto rx = net::reactor{[&](void* ctx)
+        {
+            std::lock_guard lock{mutex};
+            ready.push_back(ctx);
+            cv.notify_all();
+        }, 100ms, [&](void* ctx)
+        {
+            std::lock_guard lock{mutex};
+            idle.push_back(ctx);
+            cv.notify_all();
+        }};
+        check_true(rx.watch(quiet_r, &quiet_context));
+        check_true(rx.watch(busy_r, &busy_context));
+
+        const char byte = 'x';
+        check_eq(posix::write(busy_w, &byte, 1), 1l);
+        {
+            std::unique_lock lock{mutex};
+            check_true(cv.wait_for(lock, 2s, [&]{ return not idle.empty(); }));
+        }
+
+        // Expired fds are out of epoll: a late write is not delivered.
+        check_eq(posix::write(quiet_w, &byte, 1), 1l);
+        std::this_thread::sleep_for(300ms);
+
+        std::lock_guard lock{mutex};
+        check_eq(ready.size(), std::size_t{1});
+        check_true(not ready.empty() and ready.front() == &busy_context);
+        check_eq(idle.size(), std::size_t{1});
+        check_true(not idle.empty() and idle.front() == &quiet_context);
+        rx.forget(busy_r);
+    };
+
+    return true;
+}
+
+const auto _ = register_reactor_tests();
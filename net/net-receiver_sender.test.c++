@@ -3,6 +3,7 @@
 // See the LICENSE file in the project root for full license text.
 
 module net;
+import :posix;
 import tester;
 import std;
 
@@ -10,6 +11,7 @@ using namespace net;
 
 namespace {
 using tester::assertions::check_eq;
+using tester::assertions::check_false;
 using tester::assertions::check_true;
 
 inline bool network_tests_enabled()
@@ -117,6 +119,238 @@ auto register_receiver_sender_tests()
         }
     };
 
+    tester::bdd::scenario("Datagram ring slots and headers, [net]") = [] {
+        tester::bdd::given("A ring of 4 slots of 32 bytes with timestamp control space") = [] {
+            auto ring = net::datagram_ring{4, 32, posix::timestamp_control_size};
+            check_eq(ring.capacity(), 4u);
+            check_eq(ring.slot_size(), 32u);
+
+            tester::bdd::then("Each header points at its own slot") = [] {
+                auto ring = net::datagram_ring{4, 32, posix::timestamp_control_size};
+                for(auto i = std::size_t{0}; i < ring.capacity(); ++i)
+                {
+                    const auto& header = ring.header(i).msg_hdr;
+                    check_eq(static_cast<std::size_t>(header.msg_iovlen), 1u);
+                    check_true(header.msg_iov->iov_base == ring.slot(i).data());
+                    check_eq(header.msg_iov->iov_len, 32u);
+                }
+            };
+
+            tester::bdd::then("prepare_receive restores lengths shrunk by a send") = [] {
+                auto ring = net::datagram_ring{4, 32, posix::timestamp_control_size};
+                ring.set_length(1, 5);
+                check_eq(ring.header(1).msg_hdr.msg_iov->iov_len, 5u);
+                ring.prepare_receive(ring.capacity());
+                check_eq(ring.header(1).msg_hdr.msg_iov->iov_len, 32u);
+                check_eq(static_cast<std::size_t>(ring.header(1).msg_hdr.msg_controllen), posix::timestamp_control_size);
+            };
+        };
+    };
+
+    tester::bdd::scenario("Batched multicast round-trip, [net]") = [] {
+        if(not network_tests_enabled()) return;
+
+        using namespace std::chrono_literals;
+        auto received = std::vector<std::string>{};
+        auto timestamps_recent = true;
+        auto sent = std::uint64_t{0};
+        auto batches = std::uint64_t{0};
+        try {
+            const auto options = net::datagram_options{.batch = 16, .max_size = 64, .timestamps = true};
+            auto in = net::join_datagrams("228.0.0.4", "54322", options);
+            auto out = net::distribute_datagrams("228.0.0.4", "54322", options);
+            check_false(out.push(std::string(65, 'x')));
+            for(auto i = 0; i < 40; ++i)
+                out.push(std::format("message {}", i));
+            out.flush();
+            sent = out.sent();
+
+            const auto now = std::chrono::system_clock::now();
+            while(received.size() < 40)
+            {
+                const auto batch = in.receive(1s);
+                if(batch.empty()) break;
+                for(const auto& d : batch)
+                {
+                    received.emplace_back(d.payload);
+                    if(posix::so_timestampns != 0)
+                        timestamps_recent = timestamps_recent and d.timestamp > now - 10s and d.timestamp < now + 10s;
+                }
+            }
+            batches = in.batches();
+            check_true(in.leave());
+            check_true(in.receive(10ms).empty());
+        } catch(...) {
+            tester::assertions::warning("Batched multicast failed (multicast may be unavailable on this host/network)");
+            return;
+        }
+
+        check_eq(sent, 40u);
+        check_true(timestamps_recent);
+        for(auto i = std::size_t{0}; i < received.size(); ++i)
+            check_eq(received[i], std::format("message {}", i));
+        if(received.size() != 40)
+            tester::assertions::warning("Batched multicast data incomplete (multicast may be unavailable on this host/network)");
+        else
+            check_true(batches < 40u);
+    };
+
+    tester::bdd::scenario("Receiver leave stops delivery to its streams, [net]") = [] {
+        if(not network_tests_enabled()) return;
+
+        using namespace std::chrono_literals;
+        auto first = std::string{};
+        auto after_leave = false;
+        try {
+            auto rver = net::receiver{"228.0.0.4", "54323"};
+            auto is = rver.join();
+            auto os = net::distribute("228.0.0.4", "54323");
+            os << "before" << std::endl;
+            if(is.wait_for(2s)) std::getline(is, first);
+            rver.leave();
+            os << "after" << std::endl;
+            after_leave = is.wait_for(300ms);
+        } catch(...) {
+            tester::assertions::warning("Receiver leave failed (multicast may be unavailable on this host/network)");
+            return;
+        }
+
+        if(first != "before") {
+            tester::assertions::warning("Multicast data incomplete (multicast may be unavailable on this host/network)");
+            return;
+        }
+        check_false(after_leave);
+    };
+
+    tester::bdd::scenario("Receiver join leaves no socket behind its streams, [net]") = [] {
+        if(not network_tests_enabled()) return;
+
+        // procfs link ("socket:[inode]") of a stream's socket; empty without /proc.
+        const auto socket_link = [](const net::iendpointstream& is)
+        {
+            const auto fd = static_cast<net::endpointbuf_base*>(is.rdbuf())->native_handle();
+            auto ec = std::error_code{};
+            return std::filesystem::read_symlink(std::format("/proc/self/fd/{}", fd), ec).string();
+        };
+        // Descriptors of this process still open on `link`'s socket.
+        const auto handles = [](const std::string& link)
+        {
+            auto ec = std::error_code{};
+            auto n = 0;
+            for(const auto& entry : std::filesystem::directory_iterator{"/proc/self/fd", ec})
+            {
+                auto ignored = std::error_code{};
+                n += std::filesystem::read_symlink(entry.path(), ignored).string() == link ? 1 : 0;
+            }
+            return n;
+        };
+
+        try {
+            auto rver = net::receiver{"228.0.0.4", "54324"};
+            auto links = std::vector<std::string>{};
+            for(auto i = 0; i < 4; ++i)
+            {
+                auto is = rver.join();
+                links.push_back(socket_link(is));
+            }
+            if(links.front().empty())
+                return;
+            // Closing a stream closes its only descriptor.
+            for(const auto& link : links)
+                check_eq(handles(link), 0);
+
+            // leave() reaches the streams still open and skips closed ones.
+            auto live = rver.join();
+            const auto link = socket_link(live);
+            rver.leave();
+            check_eq(handles(link), 1);
+            rver.leave();
+        } catch(...) {
+            tester::assertions::warning("Receiver join failed (multicast may be unavailable on this host/network)");
+        }
+    };
+
+    // Hidden behind [.benchmark]; select with --tags='\[\.benchmark\]'.
+    tester::bdd::scenario("Multicast loopback, stream vs batched datagrams, [.benchmark]") = [] {
+        using namespace std::chrono_literals;
+        constexpr auto total = std::size_t{200'000};
+        constexpr auto idle = 300ms;
+        const auto payload = std::string(63, 'm');
+
+        // Offer `total` messages as fast as the sender allows while a second
+        // thread drains the group; the clock stops at the last receive.
+        const auto report = [total](std::string_view path, std::size_t received, std::uint64_t send_calls,
+                                    std::uint64_t receive_calls, double send_seconds, double seconds)
+        {
+            std::clog << std::format("multicast path={} sent={} received={} drop_rate={:.4f} "
+                                     "send_msgs_per_s={:.0f} receive_msgs_per_s={:.0f} send_calls={} receive_calls={}\n",
+                                     path, total, received,
+                                     1.0 - static_cast<double>(received) / static_cast<double>(total),
+                                     static_cast<double>(total) / send_seconds,
+                                     static_cast<double>(received) / seconds, send_calls, receive_calls);
+        };
+
+        try {
+            auto in = net::join("228.0.0.4", "54331");
+            auto out = net::distribute("228.0.0.4", "54331");
+            auto received = std::size_t{0};
+            auto last = std::chrono::steady_clock::now();
+            auto reader = std::thread{[&in, &received, &last, idle]
+            {
+                auto line = std::string{};
+                while(in.wait_for(idle) and std::getline(in, line))
+                {
+                    ++received;
+                    last = std::chrono::steady_clock::now();
+                }
+            }};
+            const auto begin = std::chrono::steady_clock::now();
+            for(auto i = std::size_t{0}; i < total; ++i)
+                out << payload << std::endl;
+            const auto sent_at = std::chrono::steady_clock::now();
+            reader.join();
+            report("stream", received, total, received,
+                   std::chrono::duration<double>(sent_at - begin).count(),
+                   std::chrono::duration<double>(std::max(last, sent_at) - begin).count());
+        } catch(...) {
+            tester::assertions::warning("Multicast stream path unavailable (multicast may be disabled on this host)");
+            return;
+        }
+
+        for(const auto receive_buffer : {0, 4 << 20})
+        {
+            try {
+                const auto options = datagram_options{.batch = 64, .max_size = 256, .receive_buffer = receive_buffer};
+                auto in = join_datagrams("228.0.0.4", "54332", options);
+                auto out = distribute_datagrams("228.0.0.4", "54332", options);
+                const auto message = payload + '\n';
+                auto received = std::size_t{0};
+                auto last = std::chrono::steady_clock::now();
+                auto reader = std::thread{[&in, &received, &last, idle]
+                {
+                    while(true)
+                    {
+                        const auto batch = in.receive(idle);
+                        if(batch.empty()) break;
+                        received += batch.size();
+                        last = std::chrono::steady_clock::now();
+                    }
+                }};
+                const auto begin = std::chrono::steady_clock::now();
+                for(auto i = std::size_t{0}; i < total; ++i)
+                    out.push(message);
+                out.flush();
+                const auto sent_at = std::chrono::steady_clock::now();
+                reader.join();
+                report(receive_buffer ? "batched_rcvbuf_4m" : "batched", received, out.batches(), in.batches(),
+                       std::chrono::duration<double>(sent_at - begin).count(),
+                       std::chrono::duration<double>(std::max(last, sent_at) - begin).count());
+            } catch(...) {
+                tester::assertions::warning("Multicast batched path unavailable (multicast may be disabled on this host)");
+            }
+        }
+    };
+
     return true;
 }
 
@@ -22,6 +22,40 @@ using tester::assertions::check_false;
 using tester::assertions::check_true;
 using tester::assertions::require_eq;
 using tester::assertions::require_true;
+using tester::assertions::warning;
+
+// SSE subscriber whose socket is replaced by a byte/flush counter, so the
+// fan-out benchmark measures formatting and delivery rather than the kernel.
+struct counting_subscriber
+{
+    struct counting_buf : std::streambuf
+    {
+        std::size_t bytes = 0;
+        std::size_t flushes = 0;
+
+        std::streamsize xsputn(const char*, std::streamsize n) override
+        {
+            bytes += static_cast<std::size_t>(n);
+            return n;
+        }
+
+        int_type overflow(int_type ch) override
+        {
+            ++bytes;
+            return traits_type::not_eof(ch);
+        }
+
+        int sync() override
+        {
+            ++flushes;
+            return 0;
+        }
+    };
+
+    counting_buf buf;
+    std::ostream os{&buf};
+    http::sse::session session{os};
+};
 
 auto register_sse_tests()
 {
@@ -102,6 +136,231 @@ auto register_sse_tests()
         };
     };
 
+    test_case("SSE hub fan-out, [net]") = []
+    {
+        using namespace std::chrono_literals;
+
+        section("send_blocks writes a batch with one flush") = []
+        {
+            auto buf = std::stringbuf{};
+            auto os = std::ostream{&buf};
+            auto s = session{os};
+            const auto blocks = std::array{"data: 1\n\n"sv, "data: 2\n\n"sv};
+            require_true(s.send_blocks(blocks));
+            check_eq(buf.str(), "data: 1\n\ndata: 2\n\n"s);
+            check_eq(s.bytes_out(), buf.str().size());
+        };
+
+        section("parse_event_id accepts plain decimal ids only") = []
+        {
+            check_eq(parse_event_id("42").value_or(0), 42u);
+            check_false(parse_event_id("").has_value());
+            check_false(parse_event_id("4x").has_value());
+            check_false(parse_event_id("-1").has_value());
+        };
+
+        section("Last-Event-ID replays missed events, then live ones follow") = []
+        {
+            auto events = hub{{.replay_capacity = 4, .heartbeat = 20ms}};
+            for(auto i = 1; i <= 6; ++i)
+                events.publish(std::to_string(i), "tick");
+
+            auto buf = std::stringbuf{};
+            auto os = std::ostream{&buf};
+            auto s = session{os};
+            auto subscriber = std::thread{[&events, &s] { events.serve(s, "4"); }};
+            while(events.subscribers() == 0)
+                std::this_thread::sleep_for(1ms);
+            check_eq(events.publish("live"), 7u);
+            while(events.stats().delivered < 3)
+                std::this_thread::sleep_for(1ms);
+            events.close();
+            subscriber.join();
+
+            check_true(buf.str().starts_with(
+                "event: tick\ndata: 5\nid: 5\n\nevent: tick\ndata: 6\nid: 6\n\ndata: live\nid: 7\n\n"));
+            check_eq(events.stats().replayed, 2u);
+            check_eq(events.subscribers(), 0u);
+        };
+
+        section("Replay starts at the oldest kept event after a gap") = []
+        {
+            auto events = hub{{.replay_capacity = 3}};
+            for(auto i = 1; i <= 10; ++i)
+                events.publish(std::to_string(i));
+
+            auto buf = std::stringbuf{};
+            auto os = std::ostream{&buf};
+            auto s = session{os};
+            auto subscriber = std::thread{[&events, &s] { events.serve(s, "2"); }};
+            while(events.stats().delivered < 3)
+                std::this_thread::sleep_for(1ms);
+            events.close();
+            subscriber.join();
+            check_eq(buf.str(), "data: 8\nid: 8\n\ndata: 9\nid: 9\n\ndata: 10\nid: 10\n\n"s);
+        };
+
+        section("A subscriber too far behind is evicted; publish never blocks") = []
+        {
+            // Stalls every write until released, like a client that stopped reading.
+            struct stalled_buf : std::stringbuf
+            {
+                std::atomic<bool> released{false};
+                std::streamsize xsputn(const char* s, std::streamsize n) override
+                {
+                    while(not released)
+                        std::this_thread::sleep_for(std::chrono::milliseconds{1});
+                    return std::stringbuf::xsputn(s, n);
+                }
+            };
+
+            auto events = hub{{.queue_capacity = 4}};
+            auto buf = stalled_buf{};
+            auto os = std::ostream{&buf};
+            auto s = session{os};
+            auto subscriber = std::thread{[&events, &s] { events.serve(s); }};
+            while(events.subscribers() == 0)
+                std::this_thread::sleep_for(1ms);
+            events.publish("first");
+            std::this_thread::sleep_for(20ms);
+            for(auto i = 0; i < 10; ++i)
+                events.publish("more");
+            check_eq(events.stats().published, 11u);
+            // The publisher evicted it while its write was still stalled.
+            check_eq(events.stats().evicted, 1u);
+            check_true(s.closed());
+            buf.released = true;
+            subscriber.join();
+            check_eq(events.stats().evicted, 1u);
+            check_eq(events.subscribers(), 0u);
+        };
+    };
+
+    // Hidden behind [.benchmark]; select with --tags='\[\.benchmark\]'.
+    test_case("SSE fan-out, per-client sessions vs hub, [.benchmark]") = [] {
+        constexpr auto events = std::size_t{200};
+        const auto payload = R"({"type":"price","symbol":"ACME","bid":101.25,"ask":101.5,"seq":123456})"s;
+        const auto seconds_since = [](std::chrono::steady_clock::time_point begin)
+        {
+            return std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+        };
+
+        for(const auto subscribers : {std::size_t{1'000}, std::size_t{10'000}})
+        {
+            const auto deliveries = subscribers * events;
+            auto sinks = std::vector<std::unique_ptr<counting_subscriber>>{};
+            for(auto i = std::size_t{0}; i < subscribers; ++i)
+                sinks.push_back(std::make_unique<counting_subscriber>());
+            auto threads = std::vector<std::thread>{};
+            const auto spawn = [&threads](auto body)
+            {
+                try {
+                    body();
+                    return true;
+                } catch(const std::system_error&) {
+                    return false;
+                }
+            };
+
+            // Former pattern: a handler thread per client waits for new data,
+            // then formats and flushes every event itself.
+            struct
+            {
+                std::mutex mutex;
+                std::condition_variable cv;
+                std::vector<std::string> data;
+                bool done = false;
+            } feed;
+            feed.data.reserve(events);
+            auto spawned = spawn([&] {
+                for(auto& sink : sinks)
+                    threads.emplace_back([&feed, &sink] {
+                        for(auto next = std::size_t{0};;)
+                        {
+                            auto lock = std::unique_lock{feed.mutex};
+                            feed.cv.wait(lock, [&] { return feed.data.size() > next or feed.done; });
+                            if(feed.data.size() == next)
+                                return;
+                            const auto end = feed.data.size();
+                            lock.unlock();
+                            for(; next < end; ++next)
+                                sink->session.send_event("price", feed.data[next], std::to_string(next + 1));
+                        }
+                    });
+            });
+            auto begin = std::chrono::steady_clock::now();
+            for(auto e = std::size_t{0}; spawned and e < events; ++e)
+            {
+                {
+                    auto lock = std::lock_guard{feed.mutex};
+                    feed.data.push_back(payload);
+                }
+                feed.cv.notify_all();
+            }
+            {
+                auto lock = std::lock_guard{feed.mutex};
+                feed.done = true;
+            }
+            feed.cv.notify_all();
+            for(auto& t : threads)
+                t.join();
+            threads.clear();
+            const auto per_client_s = seconds_since(begin);
+            auto per_client_flushes = std::size_t{0};
+            for(auto& sink : sinks)
+                per_client_flushes += std::exchange(sink->buf.flushes, 0);
+
+            if(not spawned)
+            {
+                warning("Not enough threads for one SSE handler per subscriber; skipping this size");
+                continue;
+            }
+            std::clog << std::format("sse subscribers={} events={} per_client_events_per_s={:.0f} per_client_flushes={}\n",
+                                     subscribers, events, static_cast<double>(deliveries) / per_client_s,
+                                     per_client_flushes);
+
+            // Hub: one format per event; each thread sends what accumulated
+            // during the flush delay.
+            for(const auto flush_delay : {std::chrono::microseconds{0}, std::chrono::microseconds{1'000},
+                                          std::chrono::microseconds{10'000}})
+            {
+                auto events_hub = hub{{.queue_capacity = events, .flush_delay = flush_delay}};
+                spawned = spawn([&] {
+                    for(auto& sink : sinks)
+                        threads.emplace_back([&events_hub, &sink] { events_hub.serve(sink->session); });
+                });
+                while(spawned and events_hub.subscribers() < subscribers)
+                    std::this_thread::sleep_for(std::chrono::milliseconds{1});
+
+                begin = std::chrono::steady_clock::now();
+                for(auto e = std::size_t{0}; spawned and e < events; ++e)
+                    events_hub.publish(payload, "price");
+                const auto publish_s = seconds_since(begin);
+                const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds{60};
+                while(spawned and events_hub.stats().delivered + events_hub.stats().evicted * events < deliveries
+                      and std::chrono::steady_clock::now() < deadline)
+                    std::this_thread::sleep_for(std::chrono::milliseconds{1});
+                const auto hub_s = seconds_since(begin);
+                events_hub.close();
+                for(auto& t : threads)
+                    t.join();
+                threads.clear();
+                if(not spawned)
+                    break;
+
+                const auto stats = events_hub.stats();
+                check_true(stats.delivered + stats.evicted * events >= deliveries);
+                std::clog << std::format("sse subscribers={} events={} hub_flush_delay_us={} "
+                                         "hub_events_per_s={:.0f} hub_publish_us_per_event={:.1f} hub_flushes={} "
+                                         "hub_evicted={}\n",
+                                         subscribers, events, flush_delay.count(),
+                                         static_cast<double>(stats.delivered) / hub_s,
+                                         publish_s * 1e6 / static_cast<double>(events), stats.writes,
+                                         stats.evicted);
+            }
+        }
+    };
+
     return true;
 }
 
@@ -3,6 +3,7 @@
 // See the LICENSE file in the project root for full license text.
 
 module net;
+import :posix;
 import tester;
 import std;
 using namespace std::string_view_literals;
@@ -11,6 +12,29 @@ using namespace std::chrono_literals;
 
 using namespace net;
 
+namespace net::test {
+
+void publish_slog_capture(std::shared_ptr<std::ostream> sink)
+{
+    std::lock_guard lock{structured_log_stream::process_mutex()};
+    structured_log_stream::set_capture(std::move(sink));
+}
+
+void clear_slog_capture()
+{
+    std::lock_guard lock{structured_log_stream::process_mutex()};
+    structured_log_stream::set_capture(nullptr);
+}
+
+// recursive: slog_capture may already hold this while listen_ephemeral locks again.
+std::recursive_mutex& slog_capture_mutex()
+{
+    static std::recursive_mutex mutex;
+    return mutex;
+}
+
+} // namespace net::test
+
 namespace {
 using tester::assertions::check_true;
 using tester::assertions::check_eq;
@@ -37,6 +61,85 @@ inline std::ostream& operator<<(std::ostream& os, throwing_log_value)
     return os;
 }
 
+inline std::string scratch_log_path()
+{
+    static auto counter = std::atomic<int>{0};
+    return (std::filesystem::temp_directory_path()
+            / std::format("net_slog_{}_{}.log", std::chrono::steady_clock::now().time_since_epoch().count(), counter++)).string();
+}
+
+inline std::vector<std::string> read_lines(const std::string& path)
+{
+    auto in = std::ifstream{path};
+    auto lines = std::vector<std::string>{};
+    for(auto line = std::string{}; std::getline(in, line);)
+        lines.push_back(line);
+    return lines;
+}
+
+// One HTTP_RESPONSE-shaped slog entry, as handle() writes per request.
+inline void log_response(std::string_view uri, std::size_t i)
+{
+    slog << net::info("HTTP_RESPONSE") << "response " << 200
+         << std::pair{"ip"sv, "127.0.0.1"sv}
+         << std::pair{"port", 40000 + static_cast<int>(i % 1000)}
+         << std::pair{"method", "GET"sv}
+         << std::pair{"uri", uri}
+         << std::pair{"status", 200}
+         << std::pair{"content_length", 1024LL}
+         << std::pair{"request_id", static_cast<long long>(i)}
+         << std::pair{"duration_ms", 0LL}
+         << net::flush;
+}
+
+struct slog_figures
+{
+    double seconds = 0;
+    std::vector<long long> latencies_ns;
+
+    long long percentile(double q)
+    {
+        if(latencies_ns.empty())
+            return 0;
+        const auto at = latencies_ns.begin() + static_cast<std::ptrdiff_t>(q * static_cast<double>(latencies_ns.size() - 1));
+        std::ranges::nth_element(latencies_ns, at);
+        return *at;
+    }
+};
+
+// `threads` threads logging `total` entries between them, each timed; every
+// thread runs `setup` first (slog redirects are thread-local).
+inline slog_figures measure_slog(std::size_t threads, std::size_t total, auto setup)
+{
+    auto figures = slog_figures{};
+    auto merge = std::mutex{};
+    auto go = std::atomic<bool>{false};
+    auto workers = std::vector<std::thread>{};
+    for(auto t = std::size_t{0}; t < threads; ++t)
+        workers.emplace_back([&figures, &merge, &go, &setup, n = total / threads]
+        {
+            setup();
+            auto latencies = std::vector<long long>{};
+            latencies.reserve(n);
+            while(not go.load(std::memory_order_acquire))
+                std::this_thread::yield();
+            for(auto i = std::size_t{0}; i < n; ++i)
+            {
+                const auto begin = std::chrono::steady_clock::now();
+                log_response("/api/v1/users/12345/orders?page=2"sv, i);
+                latencies.push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - begin).count());
+            }
+            std::lock_guard lock{merge};
+            figures.latencies_ns.insert(figures.latencies_ns.end(), latencies.begin(), latencies.end());
+        });
+    const auto begin = std::chrono::steady_clock::now();
+    go.store(true, std::memory_order_release);
+    for(auto& w : workers)
+        w.join();
+    figures.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+    return figures;
+}
+
 }
 
 auto register_structured_log_stream_tests()
@@ -1174,6 +1277,162 @@ auto register_structured_log_stream_tests()
         };
     };
 
+
+    tester::bdd::scenario("Async mode batches whole lines from many threads, [net]") = [] {
+        // Async mode is process-wide: keep servers and captures of other
+        // tests from logging into the file meanwhile.
+        const auto gate = std::lock_guard{test::slog_capture_mutex()};
+        const auto path = scratch_log_path();
+        constexpr auto threads = 4;
+        constexpr auto per_thread = 500;
+
+        slog.app_name("testapp")
+            .log_level(syslog::severity::info)
+            .format(log_format::jsonl)
+            .redirect(std::clog);
+        slog.async(path);
+        check_true(slog.async());
+
+        auto workers = std::vector<std::thread>{};
+        for(auto t = 0; t < threads; ++t)
+            workers.emplace_back([t] {
+                for(auto i = 0; i < per_thread; ++i)
+                    slog << net::info("ASYNC_LINE") << "entry " << i
+                         << std::pair{"thread"sv, t}
+                         << std::pair{"seq"sv, i}
+                         << net::flush;
+                // Filtered entries never reach the ring.
+                slog << net::debug("ASYNC_FILTERED") << "hidden" << net::flush;
+            });
+        for(auto& w : workers)
+            w.join();
+
+        check_true(slog.drain(std::chrono::seconds{5}));
+        const auto stats = slog.async_stats();
+        slog.sync();
+        check_true(not slog.async());
+
+        const auto lines = read_lines(path);
+        std::filesystem::remove(path);
+
+        check_eq(lines.size(), std::size_t{threads * per_thread});
+        check_eq(stats.entries, std::uint64_t{threads * per_thread});
+        check_eq(stats.dropped, std::uint64_t{0});
+        check_true(stats.writes >= 1);
+        check_true(stats.bytes > 0);
+
+        tester::bdd::then("Every line is a complete entry, in order per thread") = [lines] {
+            auto next = std::array<int, threads>{};
+            auto ordered = true;
+            for(const auto& line : lines)
+            {
+                check_true(line.starts_with("{\"time\":") and line.ends_with("}"));
+                check_true(not line.contains("ASYNC_FILTERED"));
+                for(auto t = 0; t < threads; ++t)
+                    if(line.contains(std::format("\"seq\":{},\"thread\":{}}}", next[t], t)))
+                    {
+                        ++next[t];
+                        break;
+                    }
+            }
+            for(const auto n : next)
+                ordered = ordered and n == per_thread;
+            check_true(ordered);
+        };
+    };
+
+    tester::bdd::scenario("Async mode drops and counts lines when the writer falls behind, [net]") = [] {
+        // Async mode and the syslog format are process-wide.
+        const auto gate = std::lock_guard{test::slog_capture_mutex()};
+        int fds[2];
+        if(posix::pipe(fds) != 0)
+            return;
+        constexpr auto attempts = 4000;
+
+        slog.app_name("testapp")
+            .log_level(syslog::severity::info)
+            .format(log_format::syslog)
+            .facility(syslog::facility::user)
+            .redirect(std::clog);
+        // Nobody reads the pipe yet: the writer blocks once it is full and the
+        // 4 KiB ring overflows behind it.
+        slog.async(fds[1], 4096, log_overflow::drop);
+        for(auto i = 0; i < attempts; ++i)
+            slog << net::info("ASYNC_DROP") << "padding padding padding padding padding padding " << i << net::flush;
+        const auto stats = slog.async_stats();
+
+        auto received = std::string{};
+        auto reader = std::thread{[fd = fds[0], &received] {
+            char buffer[4096];
+            for(auto n = posix::read(fd, buffer, sizeof buffer); n > 0; n = posix::read(fd, buffer, sizeof buffer))
+                received.append(buffer, static_cast<std::size_t>(n));
+        }};
+        slog.sync();
+        posix::close(fds[1]);
+        reader.join();
+        posix::close(fds[0]);
+        slog.format(log_format::jsonl);
+
+        check_true(stats.dropped > 0);
+        check_eq(stats.entries + stats.dropped, std::uint64_t{attempts});
+        check_eq(static_cast<std::uint64_t>(std::ranges::count(received, '\n')), stats.entries);
+        check_true(received.starts_with("<14>1 "));
+    };
+
+    // Hidden behind [.benchmark]; select with --tags='\[\.benchmark\]'.
+    tester::bdd::scenario("Structured log throughput, sync vs async, [.benchmark]") = [] {
+        const auto gate = std::lock_guard{test::slog_capture_mutex()};
+        constexpr auto total = std::size_t{200'000};
+        const auto previous = slog.log_level();
+        const auto path = scratch_log_path();
+        slog.log_level(syslog::severity::info).redirect(std::clog);
+
+        // Filtered entries: the level check is the whole cost.
+        {
+            slog.log_level(syslog::severity::notice);
+            const auto begin = std::chrono::steady_clock::now();
+            for(auto i = std::size_t{0}; i < total; ++i)
+                log_response("/api/v1/users/12345/orders?page=2"sv, i);
+            const auto filtered = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+            slog.log_level(syslog::severity::info);
+            std::clog << std::format("slog filtered_ns_per_entry={:.1f}\n", filtered * 1e9 / static_cast<double>(total));
+        }
+
+        for(const auto format : {log_format::syslog, log_format::jsonl})
+        {
+            slog.format(format);
+            for(const auto threads : {std::size_t{1}, std::size_t{4}, std::size_t{8}})
+            {
+                // Synchronous: one shared file stream behind the slog output mutex.
+                auto file = std::ofstream{path, std::ios::trunc};
+                auto sync = measure_slog(threads, total, [&file] { slog.redirect(file); });
+                file.close();
+
+                // Async: per-thread rings, one writer; block so every line is written.
+                slog.async(path, structured_log_stream::default_async_ring_bytes, log_overflow::block);
+                auto async = measure_slog(threads, total, [] { slog.redirect(std::clog); });
+                const auto written = slog.drain(std::chrono::seconds{30});
+                const auto stats = slog.async_stats();
+                slog.sync();
+
+                std::clog << std::format("slog format={} threads={} entries={} "
+                                         "sync_entries_per_s={:.0f} sync_p50_ns={} sync_p99_ns={} sync_p999_ns={} "
+                                         "async_entries_per_s={:.0f} async_p50_ns={} async_p99_ns={} async_p999_ns={} "
+                                         "async_writes={} async_dropped={} async_backpressure={} drained={}\n",
+                                         format == log_format::jsonl ? "jsonl" : "syslog", threads, total,
+                                         static_cast<double>(total) / sync.seconds,
+                                         sync.percentile(0.5), sync.percentile(0.99), sync.percentile(0.999),
+                                         static_cast<double>(total) / async.seconds,
+                                         async.percentile(0.5), async.percentile(0.99), async.percentile(0.999),
+                                         stats.writes, stats.dropped, stats.backpressure, written);
+            }
+        }
+
+        auto ec = std::error_code{};
+        std::filesystem::remove(path, ec);
+        slog.format(log_format::jsonl).log_level(previous).redirect(std::clog);
+    };
+
     return true;
 }
 
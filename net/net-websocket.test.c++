@@ -87,9 +87,11 @@ private:
 
 // Bind 127.0.0.1:0. Uses a shared promise so a late listen callback cannot
 // set_value on a destroyed stack promise (std::terminate under --jobs>1).
-inline std::pair<joining_server_thread, std::uint16_t> listen_ephemeral(const std::shared_ptr<http::server>& server)
+inline std::tuple<joining_server_thread, std::uint16_t, std::shared_ptr<std::unique_lock<std::recursive_mutex>>>
+listen_ephemeral(const std::shared_ptr<http::server>& server)
 {
     using namespace std::chrono_literals;
+    auto gate = std::make_shared<std::unique_lock<std::recursive_mutex>>(net::test::slog_capture_mutex());
     auto port = std::make_shared<std::uint16_t>(0);
     auto bound = std::make_shared<std::promise<void>>();
     auto bound_future = bound->get_future();
@@ -109,8 +111,8 @@ inline std::pair<joining_server_thread, std::uint16_t> listen_ephemeral(const st
         }
     }};
     if(bound_future.wait_for(3s) != std::future_status::ready)
-        return {joining_server_thread{server, std::move(t)}, 0};
-    return {joining_server_thread{server, std::move(t)}, *port};
+        return {joining_server_thread{server, std::move(t)}, 0, std::move(gate)};
+    return {joining_server_thread{server, std::move(t)}, *port, std::move(gate)};
 }
 
 inline frame make_masked_text(std::string_view text, std::uint32_t key = 0x01020304u)
@@ -504,7 +506,7 @@ auto register_websocket_tests()
         });
 
         using namespace std::chrono_literals;
-        auto [server_thread, port] = listen_ephemeral(server);
+        auto [server_thread, port, _http_listen_gate] = listen_ephemeral(server);
         require_true(port != 0);
         const auto port_s = std::to_string(port);
         std::this_thread::sleep_for(50ms);
@@ -559,7 +561,7 @@ auto register_websocket_tests()
         });
 
         using namespace std::chrono_literals;
-        auto [server_thread, port] = listen_ephemeral(server);
+        auto [server_thread, port, _http_listen_gate] = listen_ephemeral(server);
         require_true(port != 0);
         const auto port_s = std::to_string(port);
         std::this_thread::sleep_for(50ms);
@@ -596,7 +598,7 @@ auto register_websocket_tests()
         });
 
         using namespace std::chrono_literals;
-        auto [server_thread, port] = listen_ephemeral(server);
+        auto [server_thread, port, _http_listen_gate] = listen_ephemeral(server);
         require_true(port != 0);
         const auto port_s = std::to_string(port);
         std::this_thread::sleep_for(50ms);
@@ -625,7 +627,7 @@ auto register_websocket_tests()
         });
 
         using namespace std::chrono_literals;
-        auto [server_thread, port] = listen_ephemeral(server);
+        auto [server_thread, port, _http_listen_gate] = listen_ephemeral(server);
         require_true(port != 0);
         const auto port_s = std::to_string(port);
         std::this_thread::sleep_for(50ms);
@@ -1047,7 +1049,7 @@ auto register_websocket_tests()
         });
 
         using namespace std::chrono_literals;
-        auto [server_thread, port] = listen_ephemeral(server);
+        auto [server_thread, port, _http_listen_gate] = listen_ephemeral(server);
         require_true(port != 0);
         const auto port_s = std::to_string(port);
         std::this_thread::sleep_for(50ms);
@@ -1080,7 +1082,7 @@ auto register_websocket_tests()
         });
 
         using namespace std::chrono_literals;
-        auto [server_thread, port] = listen_ephemeral(server);
+        auto [server_thread, port, _http_listen_gate] = listen_ephemeral(server);
         require_true(port != 0);
         const auto port_s = std::to_string(port);
         std::this_thread::sleep_for(50ms);
@@ -1104,6 +1106,368 @@ auto register_websocket_tests()
             server_thread.join();
     };
 
+    tester::bdd::scenario("apply_mask word path matches the byte-wise definition, [net]") = [] {
+        const auto key = 0xA1B2C3D4u;
+        const auto key_bytes = std::array{0xA1u, 0xB2u, 0xC3u, 0xD4u};
+        auto all_match = true;
+        for(auto size = std::size_t{0}; size < 100; ++size)
+        {
+            auto data = std::vector<std::byte>(size);
+            for(auto i = std::size_t{0}; i < size; ++i)
+                data[i] = static_cast<std::byte>(i * 7);
+            apply_mask(data, key);
+            for(auto i = std::size_t{0}; i < size; ++i)
+                all_match = all_match and std::to_integer<unsigned>(data[i]) == (((i * 7) & 0xFFu) ^ key_bytes[i % 4]);
+        }
+        check_true(all_match);
+
+        tester::bdd::then("Masking in pieces at an offset equals masking the whole") = [key] {
+            auto whole = std::vector<std::byte>(77, std::byte{0x5A});
+            auto pieces = whole;
+            apply_mask(whole, key);
+            apply_mask(std::span{pieces}.first(13), key, 0);
+            apply_mask(std::span{pieces}.subspan(13), key, 13);
+            check_true(whole == pieces);
+        };
+    };
+
+    tester::bdd::scenario("is_valid_utf8 checks bytes after long ASCII runs, [net]") = [] {
+        const auto ascii = std::string(45, 'a');
+        check_true(is_valid_utf8(ascii));
+        check_true(is_valid_utf8(ascii + "€" + ascii + "äö"));
+        check_true(not is_valid_utf8(ascii + "\xFF" + ascii));
+        check_true(not is_valid_utf8(ascii + "\xC0\x80"));        // overlong after a block
+        check_true(not is_valid_utf8(ascii + "\xED\xA0\x80"));   // surrogate
+        check_true(not is_valid_utf8(std::string(64, 'b') + "\xE2\x82")); // truncated at the end
+    };
+
+    tester::bdd::scenario("read_frame reuses the payload buffer between frames, [net]") = [] {
+        auto bytes = frame_bytes(make_masked_text(std::string(300, 'x')))
+                   + frame_bytes(make_masked_text("short"sv));
+        auto iss = std::istringstream{bytes};
+        auto incoming = frame{};
+        require_true(read_frame(iss, incoming) == frame_read::ok);
+        const auto* buffer = incoming.payload.data();
+        require_true(read_frame(iss, incoming) == frame_read::ok);
+        check_eq(payload_view(incoming), "short"sv);
+        check_true(incoming.payload.data() == buffer);
+
+        tester::bdd::then("A failed read leaves no stale payload") = [] {
+            auto truncated = std::istringstream{frame_bytes(make_masked_text("hello"sv)).substr(0, 4)};
+            auto f = make_text_frame("old"sv);
+            check_true(read_frame(truncated, f) != frame_read::ok);
+            check_true(f.payload.empty());
+        };
+    };
+
+    tester::bdd::scenario("write_frame masks a large payload in chunks, [net]") = [] {
+        const auto payload = std::string(10'000, 'm');
+        auto oss = std::ostringstream{};
+        require_true(write_frame(oss, opcode::text, as_payload(payload), 0x0F1E2D3Cu));
+        auto iss = std::istringstream{oss.str()};
+        auto decoded = frame{};
+        require_true(read_frame(iss, decoded) == frame_read::ok);
+        check_true(decoded.masked);
+        check_eq(payload_view(decoded), std::string_view{payload});
+    };
+
+    tester::bdd::scenario("group broadcast serializes once and drops failed members, [net]") = [] {
+        auto members = group{};
+        auto first = std::make_shared<std::string>();
+        auto second = std::make_shared<std::string>();
+        auto a = members.join([first](std::string_view wire) { first->append(wire); return std::ssize(wire); });
+        auto b = members.join([second](std::string_view wire) { second->append(wire); return std::ssize(wire); });
+        auto broken = members.join([](std::string_view) { return std::ptrdiff_t{-1}; });
+        check_eq(members.size(), std::size_t{3});
+
+        check_eq(members.broadcast("tick"sv), std::size_t{2});
+        check_eq(members.size(), std::size_t{2});
+        check_eq(*first, encode_frame(opcode::text, as_payload("tick"sv)));
+        check_eq(*first, *second);
+
+        tester::bdd::then("A member that left is never written to again") = [] {
+            auto members = group{};
+            auto calls = std::make_shared<int>(0);
+            {
+                auto m = members.join([calls](std::string_view wire) { ++*calls; return std::ssize(wire); });
+                check_eq(members.broadcast("one"sv), std::size_t{1});
+            }
+            check_eq(members.size(), std::size_t{0});
+            check_eq(members.broadcast("two"sv), std::size_t{0});
+            check_eq(*calls, 1);
+        };
+
+        tester::bdd::then("A member that takes nothing is queued, then evicted at capacity") = [] {
+            auto members = group{64};
+            auto evicted = std::make_shared<int>(0);
+            auto reader = std::make_shared<std::string>();
+            auto stuck = members.join({.write = [](std::string_view) { return std::ptrdiff_t{0}; },
+                                       .evict = [evicted] { ++*evicted; }});
+            auto live = members.join([reader](std::string_view wire) { reader->append(wire); return std::ssize(wire); });
+
+            // Each text frame is 2 + 10 bytes: five fit in 64, the sixth does not.
+            for(auto i = 0; i < 5; ++i)
+                check_eq(members.broadcast("0123456789"sv), std::size_t{2});
+            check_eq(*evicted, 0);
+            check_eq(members.broadcast("0123456789"sv), std::size_t{1});
+            check_eq(*evicted, 1);
+            check_eq(members.size(), std::size_t{1});
+            check_eq(reader->size(), std::size_t{6 * 12});
+            check_false(stuck.send("x"sv));
+        };
+
+        tester::bdd::then("Queued bytes drain in order once the peer takes them again") = [] {
+            auto members = group{};
+            auto open = std::make_shared<std::atomic<bool>>(false);
+            auto received = std::make_shared<std::string>();
+            auto lock = std::make_shared<std::mutex>();
+            auto m = members.join([open, received, lock](std::string_view wire) {
+                if(not open->load())
+                    return std::ptrdiff_t{0};
+                std::lock_guard guard{*lock};
+                received->append(wire.substr(0, 5));
+                return std::ssize(wire.substr(0, 5));
+            });
+            check_eq(members.broadcast("first"sv), std::size_t{1});
+            check_eq(members.broadcast("second"sv), std::size_t{1});
+            open->store(true);
+
+            const auto expected = encode_frame(opcode::text, as_payload("first"sv))
+                                + encode_frame(opcode::text, as_payload("second"sv));
+            const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds{3};
+            auto done = false;
+            while(not done and std::chrono::steady_clock::now() < deadline)
+            {
+                {
+                    std::lock_guard guard{*lock};
+                    done = *received == expected;
+                }
+                std::this_thread::sleep_for(std::chrono::milliseconds{5});
+            }
+            check_true(done);
+        };
+    };
+
+    tester::bdd::scenario("run_text_session in a group replies through its membership, [net]") = [] {
+        auto members = group{};
+        auto sent = std::make_shared<std::string>();
+        auto member = members.join([sent](std::string_view wire) { sent->append(wire); return std::ssize(wire); });
+        auto stream = duplex_stream{frame_bytes(make_masked_text("hi"sv)) + frame_bytes(make_masked_close())};
+        run_text_session(stream, [](std::string_view msg) {
+            return text_reply{std::string{msg} + "!"};
+        }, &member);
+
+        check_true(stream.output().empty());
+        auto iss = std::istringstream{*sent};
+        auto reply = frame{};
+        require_true(read_frame(iss, reply) == frame_read::ok);
+        check_eq(payload_view(reply), "hi!"sv);
+        require_true(read_frame(iss, reply) == frame_read::ok);
+        check_eq(reply.op, opcode::close);
+    };
+
+    tester::bdd::scenario("http server websocket group broadcast reaches every client, [net]") = [] {
+        if(not network_tests_enabled())
+            return;
+
+        auto server = std::make_shared<http::server>();
+        auto members = std::make_shared<group>();
+        server->ws("/feed").ws([](std::string_view) { return text_reply{}; }, members);
+
+        using namespace std::chrono_literals;
+        auto [server_thread, port, _http_listen_gate] = listen_ephemeral(server);
+        require_true(port != 0);
+        const auto port_s = std::to_string(port);
+
+        auto first = websocket::connect("127.0.0.1"sv, port_s, "/feed"sv);
+        auto second = websocket::connect("127.0.0.1"sv, port_s, "/feed"sv);
+        const auto deadline = std::chrono::steady_clock::now() + 3s;
+        while(members->size() < 2 and std::chrono::steady_clock::now() < deadline)
+            std::this_thread::sleep_for(5ms);
+        require_true(members->size() == 2u);
+
+        check_eq(members->broadcast("price=101.5"sv), std::size_t{2});
+        const auto a = first.recv_view();
+        require_true(a.has_value());
+        check_eq(*a, "price=101.5"sv);
+        const auto b = second.recv();
+        require_true(b.has_value());
+        check_eq(*b, "price=101.5"s);
+
+        first.close();
+        second.close();
+        server->stop();
+        if(server_thread.joinable())
+            server_thread.join();
+    };
+
+    tester::bdd::scenario("http server websocket group evicts a client that never reads, [net]") = [] {
+        if(not network_tests_enabled())
+            return;
+
+        auto server = std::make_shared<http::server>();
+        auto members = std::make_shared<group>(std::size_t{256} * 1024);
+        server->ws("/feed").ws([](std::string_view) { return text_reply{}; }, members);
+
+        using namespace std::chrono_literals;
+        auto [server_thread, port, _http_listen_gate] = listen_ephemeral(server);
+        require_true(port != 0);
+        const auto port_s = std::to_string(port);
+
+        auto reading = websocket::connect("127.0.0.1"sv, port_s, "/feed"sv);
+        auto stuck = websocket::connect("127.0.0.1"sv, port_s, "/feed"sv);
+        auto deadline = std::chrono::steady_clock::now() + 3s;
+        while(members->size() < 2 and std::chrono::steady_clock::now() < deadline)
+            std::this_thread::sleep_for(5ms);
+        require_true(members->size() == 2u);
+
+        constexpr auto messages = 1024;
+        auto received = std::atomic<int>{0};
+        auto reader = std::thread{[&reading, &received] {
+            while(received.load() < messages and reading.recv_view())
+                ++received;
+        }};
+
+        // 64 MiB in 64 KiB messages, each sent once the reader has the last
+        // one: far past the socket buffers and queue of the client that never
+        // reads, which must be evicted rather than stall the loop.
+        const auto payload = std::string(64 * 1024, 'p');
+        auto sent = 0;
+        deadline = std::chrono::steady_clock::now() + 20s;
+        for(; sent < messages and std::chrono::steady_clock::now() < deadline; ++sent)
+        {
+            members->broadcast(payload);
+            while(received.load() <= sent and std::chrono::steady_clock::now() < deadline)
+                std::this_thread::yield();
+        }
+        check_eq(sent, messages);
+        check_eq(received.load(), messages);
+        check_eq(members->size(), std::size_t{1});
+
+        // Stopping the server ends the reader's recv if anything fell short.
+        server->stop();
+        if(reader.joinable())
+            reader.join();
+        if(server_thread.joinable())
+            server_thread.join();
+    };
+
+    // Hidden behind [.benchmark]; select with --tags='\[\.benchmark\]'.
+    tester::bdd::scenario("WebSocket frame codec by payload size, [.benchmark]") = [] {
+        // The former byte-at-a-time loop, as the baseline for apply_mask.
+        const auto mask_bytewise = [](std::span<std::byte> data, std::uint32_t key)
+        {
+            const auto key_bytes = std::array{
+                static_cast<std::byte>((key >> 24) & 0xFFu), static_cast<std::byte>((key >> 16) & 0xFFu),
+                static_cast<std::byte>((key >> 8) & 0xFFu), static_cast<std::byte>(key & 0xFFu)};
+            for(std::size_t i = 0; i < data.size(); ++i)
+                data[i] ^= key_bytes[i % 4];
+        };
+        const auto gbps = [](std::size_t bytes, double seconds) { return static_cast<double>(bytes) / seconds / 1e9; };
+        const auto seconds_since = [](std::chrono::steady_clock::time_point begin)
+        {
+            return std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+        };
+
+        for(const auto size : {std::size_t{16}, std::size_t{128}, std::size_t{1024}, std::size_t{16 * 1024},
+                                std::size_t{64 * 1024}, std::size_t{1024 * 1024}})
+        {
+            const auto rounds = std::clamp<std::size_t>((std::size_t{64} << 20) / size, 64, 1'000'000);
+            const auto total = rounds * size;
+
+            auto data = std::vector<std::byte>(size, std::byte{'a'});
+            auto begin = std::chrono::steady_clock::now();
+            for(auto r = std::size_t{0}; r < rounds; ++r)
+                mask_bytewise(data, 0x12345678u + static_cast<std::uint32_t>(r));
+            const auto mask_bytewise_s = seconds_since(begin);
+            begin = std::chrono::steady_clock::now();
+            for(auto r = std::size_t{0}; r < rounds; ++r)
+                apply_mask(data, 0x12345678u + static_cast<std::uint32_t>(r));
+            const auto mask_word_s = seconds_since(begin);
+
+            const auto ascii = std::string(size, 'q');
+            auto mixed = std::string{};
+            while(mixed.size() + 2 <= size)
+                mixed += mixed.size() % 16 == 0 ? "\xC3\xA4"s : "x"s;
+            auto valid = true;
+            begin = std::chrono::steady_clock::now();
+            for(auto r = std::size_t{0}; r < rounds; ++r)
+                valid = is_valid_utf8(ascii) and valid;
+            const auto utf8_ascii_s = seconds_since(begin);
+            begin = std::chrono::steady_clock::now();
+            for(auto r = std::size_t{0}; r < rounds; ++r)
+                valid = is_valid_utf8(mixed) and valid;
+            const auto utf8_mixed_s = seconds_since(begin);
+
+            // Decode a run of masked client frames: a fresh frame per message
+            // (the former session loop) vs one frame reused for the session.
+            const auto frames = std::min<std::size_t>(rounds, std::max<std::size_t>((std::size_t{32} << 20) / size, 16));
+            auto wire = std::string{};
+            {
+                auto out = std::ostringstream{};
+                for(auto i = std::size_t{0}; i < frames; ++i)
+                    write_frame(out, opcode::text, as_payload(ascii), 0x0A0B0C0Du);
+                wire = out.str();
+            }
+            auto fresh_in = std::istringstream{wire};
+            begin = std::chrono::steady_clock::now();
+            for(auto i = std::size_t{0}; i < frames; ++i)
+            {
+                auto f = frame{};
+                valid = read_frame(fresh_in, f) == frame_read::ok and valid;
+            }
+            const auto decode_fresh_s = seconds_since(begin);
+
+            auto reused_in = std::istringstream{wire};
+            // A fresh frame allocates its payload every time; the reused one
+            // only when its buffer moves.
+            auto reused = frame{};
+            auto regrowths = std::size_t{0};
+            begin = std::chrono::steady_clock::now();
+            for(auto i = std::size_t{0}; i < frames; ++i)
+            {
+                const auto* before = reused.payload.data();
+                valid = read_frame(reused_in, reused) == frame_read::ok and valid;
+                regrowths += reused.payload.data() != before ? 1 : 0;
+            }
+            const auto decode_reused_s = seconds_since(begin);
+
+            // Fan-out to 1000 members: encode per member vs encode once.
+            constexpr auto fanout = std::size_t{1000};
+            auto sink_bytes = std::size_t{0};
+            auto members = group{};
+            auto memberships = std::vector<group::membership>{};
+            for(auto i = std::size_t{0}; i < fanout; ++i)
+                memberships.push_back(members.join([&sink_bytes](std::string_view w) { sink_bytes += w.size(); return std::ssize(w); }));
+            const auto messages = std::max<std::size_t>(rounds / fanout, 4);
+            begin = std::chrono::steady_clock::now();
+            for(auto m = std::size_t{0}; m < messages; ++m)
+                for(auto i = std::size_t{0}; i < fanout; ++i)
+                    sink_bytes += encode_frame(opcode::text, as_payload(ascii)).size();
+            const auto per_member_s = seconds_since(begin);
+            begin = std::chrono::steady_clock::now();
+            for(auto m = std::size_t{0}; m < messages; ++m)
+                members.broadcast(ascii);
+            const auto broadcast_s = seconds_since(begin);
+
+            check_true(valid);
+            std::clog << std::format("websocket payload={} mask_bytewise_gbps={:.2f} mask_word_gbps={:.2f} "
+                                     "utf8_ascii_gbps={:.2f} utf8_mixed_gbps={:.2f} "
+                                     "decode_fresh_ns={:.0f} decode_reused_ns={:.0f} "
+                                     "decode_reused_regrowths={} "
+                                     "fanout={} encode_per_member_us={:.1f} broadcast_once_us={:.1f} sink_bytes={}\n",
+                                     size, gbps(total, mask_bytewise_s), gbps(total, mask_word_s),
+                                     gbps(total, utf8_ascii_s), gbps(rounds * mixed.size(), utf8_mixed_s),
+                                     decode_fresh_s * 1e9 / static_cast<double>(frames),
+                                     decode_reused_s * 1e9 / static_cast<double>(frames),
+                                     regrowths,
+                                     fanout,
+                                     per_member_s * 1e6 / static_cast<double>(messages),
+                                     broadcast_s * 1e6 / static_cast<double>(messages),
+                                     sink_bytes);
+        }
+    };
+
     return true;
 }
 